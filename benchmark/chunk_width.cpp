@@ -0,0 +1,64 @@
+/*******************************************************************************
+ * SortChecker/benchmark/chunk_width.cpp
+ *
+ * Running time of tabulation hashing for different chunk widths
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "sort_checker.hpp"
+
+template <typename T, size_t chunk_bits>
+void run(const std::vector<T>& v, const size_t reps) {
+  using Hash = checker::common::hash_tabulated_chunked<T, chunk_bits>;
+  using Checker = checker::SortChecker<T, Hash>;
+
+  // Create the shared table outside of the measurement.
+  Checker checker;
+  double best = 0;
+  for (size_t r = 0; r < reps; ++r) {
+    checker.reset();
+    const auto begin = std::chrono::steady_clock::now();
+    for (const auto& e : v) {
+      checker.add_pre(e);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double ns = std::chrono::duration<double, std::nano>(end - begin).count() / v.size();
+    if (r == 0 || ns < best) best = ns;
+  }
+
+  std::printf("key_bytes=%zu chunk_bits=%zu lookups=%zu table_bytes=%zu ns_per_element=%.3f\n",
+              sizeof(T), chunk_bits, Hash::chunks, sizeof(typename Hash::Table), best);
+  // Prevent the compiler from dropping the hashing.
+  if (checker.is_likely_permuted()) std::printf("unexpected result\n");
+}
+
+template <typename T>
+void run_all(const size_t n, const size_t reps) {
+  std::mt19937_64 rng { 42 };
+  std::vector<T> v(n);
+  for (auto& e : v) e = static_cast<T>(rng());
+
+  run<T, 4>(v, reps);
+  run<T, 8>(v, reps);
+  run<T, 11>(v, reps);
+  run<T, 16>(v, reps);
+}
+
+int main(int argc, char* argv[]) {
+  const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t { 1 } << 24;
+  const size_t reps = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5;
+
+  run_all<uint32_t>(n, reps);
+  run_all<uint64_t>(n, reps);
+}
+
+/******************************************************************************/
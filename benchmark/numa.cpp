@@ -0,0 +1,74 @@
+/*******************************************************************************
+ * SortChecker/benchmark/numa.cpp
+ *
+ * Running time of per-thread checkers with shared and with NUMA-local tables
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "numa.hpp"
+#include "parallel.hpp"
+#include "pool.hpp"
+
+// 16 bit chunks need 1 MiB of tables, which do not fit into the L1 and L2
+// caches, so a part of the lookups goes to the memory of the table's node.
+using T = uint64_t;
+using Hash = checker::common::hash_tabulated_chunked<T, 16>;
+
+template <typename Pool>
+double run(Pool& pool, const std::vector<std::vector<T>>& v, const size_t reps) {
+  const size_t threads = v.size();
+  double best = 0;
+  for (size_t r = 0; r < reps; ++r) {
+    const auto begin = std::chrono::steady_clock::now();
+    checker::_detail::parallel_for(threads, [&](const size_t i) {
+      auto& c = pool[i];
+      c.add_pre_range(v[i].data(), v[i].data() + v[i].size());
+    });
+    const auto end = std::chrono::steady_clock::now();
+    const double ns = std::chrono::duration<double, std::nano>(end - begin).count() /
+      (threads * v[0].size());
+    if (r == 0 || ns < best) best = ns;
+  }
+  // Prevent the compiler from dropping the hashing.
+  if (pool.is_likely_permuted()) std::printf("unexpected result\n");
+  return best;
+}
+
+int main(int argc, char* argv[]) {
+  const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t { 1 } << 22;
+  const size_t reps = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5;
+  const size_t threads = argc > 3 ? std::strtoull(argv[3], nullptr, 10)
+    : std::max(1u, std::thread::hardware_concurrency());
+
+  // Each thread creates its input, so the input is local in both variants.
+  std::vector<std::vector<T>> v(threads);
+  checker::_detail::parallel_for(threads, [&](const size_t i) {
+    std::mt19937_64 rng { 42 + i };
+    v[i].resize(n);
+    for (auto& e : v[i]) e = rng();
+  });
+
+  // Checkers and tables created by the main thread
+  checker::CheckerPool<T, checker::SortChecker<T, Hash>> shared(threads);
+  // Checkers and tables on the nodes of the threads
+  checker::NumaCheckerPool<T, Hash> local(threads);
+
+  const double ns_shared = run(shared, v, reps);
+  const double ns_local = run(local, v, reps);
+
+  std::printf("numa=%d threads=%zu elements_per_thread=%zu table_bytes=%zu "
+              "shared_ns_per_element=%.3f local_ns_per_element=%.3f\n",
+              checker::_detail::numa_enabled(), threads, n, sizeof(Hash::Table),
+              ns_shared, ns_local);
+}
+
+/******************************************************************************/
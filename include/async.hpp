@@ -0,0 +1,286 @@
+/*******************************************************************************
+ * SortChecker/include/async.hpp
+ *
+ * Checking on background threads
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "pool.hpp"
+#include "segment.hpp"
+
+namespace checker {
+namespace _detail {
+
+/*!
+ * Bounded lock-free queue for multiple producers and consumers. Each cell
+ * carries a sequence number which tells producers and consumers whether the
+ * cell is free or filled in the current round, so both only synchronize on
+ * the cell and on their own position counter.
+ *
+ * See D. Vyukov, Bounded MPMC queue,
+ * https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ */
+template <typename Item>
+class bounded_queue
+{
+public:
+  //! Construct a queue of at least 'capacity' items
+  explicit bounded_queue(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) size *= 2;
+    mask = size - 1;
+    cells.reset(new cell[size]);
+    for (size_t i = 0; i < size; ++i) {
+      cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    enqueue_pos.store(0, std::memory_order_relaxed);
+    dequeue_pos.store(0, std::memory_order_relaxed);
+  }
+
+  //! Append an item, returns false if the queue is full
+  bool try_push(const Item& item) {
+    size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    cell* c;
+    for (;;) {
+      c = &cells[pos & mask];
+      const size_t seq = c->sequence.load(std::memory_order_acquire);
+      const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+    c->item = item;
+    c->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  //! Remove the first item, returns false if the queue is empty
+  bool try_pop(Item& item) {
+    size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    cell* c;
+    for (;;) {
+      c = &cells[pos & mask];
+      const size_t seq = c->sequence.load(std::memory_order_acquire);
+      const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = dequeue_pos.load(std::memory_order_relaxed);
+      }
+    }
+    item = c->item;
+    c->sequence.store(pos + mask + 1, std::memory_order_release);
+    return true;
+  }
+
+protected:
+  struct cell {
+    std::atomic<size_t> sequence;
+    Item item;
+  };
+
+  std::unique_ptr<cell[]> cells;
+  size_t mask;
+  //! Positions of the producers and the consumers on separate cache lines
+  alignas(cache_line_size) std::atomic<size_t> enqueue_pos;
+  alignas(cache_line_size) std::atomic<size_t> dequeue_pos;
+};
+
+} // namespace _detail
+
+/*!
+ * Probabilistic checker which verifies chunks of the input and the output on
+ * background threads, so the threads of the sort only pay for enqueuing.
+ *
+ * Chunks are passed by pointer and length through a bounded lock-free
+ * queue; producers wait while the queue is full. The background workers
+ * process the chunks in parallel and register them in a SegmentSortChecker,
+ * which stitches the output chunks together by their offsets. The chunks
+ * must not be modified or freed until the result of finish() is ready.
+ *
+ * \tparam T Type of the elements being permuted
+ * \tparam Comp Comparator of the output
+ * \tparam Hash Hash function
+ * \tparam Proj Projection of an element to the key it is sorted by
+ */
+template <typename T, typename Comp = std::less<>,
+          typename Hash = common::hash_default<T>, typename Proj = identity>
+class AsyncSortChecker
+{
+public:
+  /*!
+   * Construct a checker with a stateless projection and start its workers
+   *
+   * \param workers Number of background threads
+   * \param capacity Number of chunks the queue can hold
+   * \param comp Comparator
+   * \param h Hash function
+   */
+  explicit AsyncSortChecker(const size_t workers = std::thread::hardware_concurrency(),
+                            const size_t capacity = 1024, const Comp& comp = Comp{},
+                            const Hash& h = Hash{})
+    : AsyncSortChecker(workers, capacity, comp, h, Proj{})
+  {
+    static_assert(std::is_empty_v<Proj>,
+                  "Projections with state have to be passed to the constructor");
+  }
+
+  /*!
+   * Construct a checker and start its workers
+   *
+   * \param workers Number of background threads
+   * \param capacity Number of chunks the queue can hold
+   * \param comp Comparator
+   * \param h Hash function
+   * \param p Projection
+   */
+  AsyncSortChecker(size_t workers, const size_t capacity, const Comp& comp,
+                   const Hash& h, const Proj& p)
+    : queue(capacity), segments(h, p), cmp(comp), closed(false)
+  {
+    workers = std::max<size_t>(1, workers);
+    threads.reserve(workers);
+    for (size_t i = 0; i < workers; ++i) {
+      threads.emplace_back([this] { work(); });
+    }
+  }
+
+  AsyncSortChecker(const AsyncSortChecker&) = delete;
+  AsyncSortChecker& operator = (const AsyncSortChecker&) = delete;
+
+  ~AsyncSortChecker() {
+    if (!result.valid()) finish();
+    result.wait();
+  }
+
+  /*!
+   * Enqueue a chunk of elements (before sorting)
+   *
+   * \param data Pointer to the first element
+   * \param n Number of elements
+   */
+  void add_pre_chunk(const T* data, const size_t n) {
+    if (n == 0) return;
+    push(chunk { data, n, 0, false });
+  }
+
+  /*!
+   * Enqueue the chunk of the output which starts at position 'offset'
+   * (after sorting). The chunks must tile the output.
+   *
+   * \param offset Position of the chunk's first element in the output
+   * \param data Pointer to the first element
+   * \param n Number of elements
+   */
+  void add_post_chunk(const size_t offset, const T* data, const size_t n) {
+    // Empty chunks neither contain elements nor affect the tiling
+    if (n == 0) return;
+    push(chunk { data, n, offset, true });
+  }
+
+  /*!
+   * Signal that all chunks have been enqueued. The returned future becomes
+   * ready once the workers have processed all chunks and tells whether the
+   * output is likely the sorted input, see SegmentSortChecker. May be called
+   * once; no chunks may be enqueued afterwards.
+   */
+  std::shared_future<bool> finish() {
+    assert(!result.valid());
+    closed.store(true, std::memory_order_release);
+    result = std::async(std::launch::async, [this] {
+      for (auto& t : threads) {
+        t.join();
+      }
+      return segments.is_likely_sorted(cmp);
+    }).share();
+    return result;
+  }
+
+protected:
+  //! Elements enqueued for checking
+  struct chunk {
+    const T* data;
+    size_t n;
+    size_t offset;
+    bool is_post;
+  };
+
+  //! Enqueue a chunk, waits while the queue is full
+  void push(const chunk& c) {
+    assert(!closed.load(std::memory_order_relaxed));
+    while (!queue.try_push(c)) {
+      std::this_thread::yield();
+    }
+  }
+
+  //! Register a chunk in the segment checker
+  void process(const chunk& c) {
+    if (c.is_post) {
+      segments.add_post_segment(c.offset, c.data, c.data + c.n, cmp);
+    } else {
+      segments.add_pre_segment(c.data, c.data + c.n);
+    }
+  }
+
+  //! Process chunks until the queue is closed and empty
+  void work() {
+    size_t idle = 0;
+    chunk c;
+    for (;;) {
+      if (queue.try_pop(c)) {
+        idle = 0;
+        process(c);
+      } else if (closed.load(std::memory_order_acquire)) {
+        // All chunks were enqueued before closing, drain the rest
+        while (queue.try_pop(c)) {
+          process(c);
+        }
+        return;
+      } else if (++idle < 64) {
+        std::this_thread::yield();
+      } else {
+        // Back off, the producers are busy sorting
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+      }
+    }
+  }
+
+  //! Chunks waiting for a worker
+  _detail::bounded_queue<chunk> queue;
+  //! Processed chunks
+  SegmentSortChecker<T, Hash, Proj> segments;
+  //! Comparator
+  const Comp cmp;
+  //! No more chunks are enqueued
+  std::atomic<bool> closed;
+  //! Background workers
+  std::vector<std::thread> threads;
+  //! Result of the check, valid after finish()
+  std::shared_future<bool> result;
+};
+
+} // namespace checker
+
+/******************************************************************************/
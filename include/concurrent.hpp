@@ -0,0 +1,159 @@
+/*******************************************************************************
+ * SortChecker/include/concurrent.hpp
+ *
+ * Checker which may be used by any number of threads at the same time
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <type_traits>
+
+#include "pool.hpp"
+#include "sort_checker.hpp"
+
+namespace checker {
+
+/*!
+ * Probabilistic checker for permutation algorithms which accepts elements
+ * from any thread without knowing the threads in advance.
+ *
+ * Each thread adds its elements to its own shard, a SortChecker on its own
+ * cache lines. A thread registers its shard under a lock on its first call
+ * and then finds it in a thread-local table, so adding elements neither
+ * locks nor writes to memory shared with other threads. The queries combine
+ * all shards; they may only be called while no thread adds elements, e.g.,
+ * after the producers have been joined.
+ *
+ * Since the threads add the output elements in no particular order, output
+ * elements are processed with add_post_unordered, which only contributes to
+ * the permutation check, or with add_post_indexed, which also compares an
+ * element with its predecessor in the output.
+ *
+ * \tparam T Type of the elements being permuted
+ * \tparam Hash Hash function
+ * \tparam Proj Projection of an element to the key it is sorted by
+ */
+template <typename T, typename Hash = common::hash_default<T>,
+          typename Proj = identity>
+class ConcurrentSortChecker
+{
+public:
+  using Checker = SortChecker<T, Hash, Proj>;
+
+  /*!
+   * Construct a checker with a stateless projection
+   *
+   * \param h Hash function of all shards
+   */
+  explicit ConcurrentSortChecker(const Hash& h = Hash{})
+    : ConcurrentSortChecker(h, Proj{})
+  {
+    static_assert(std::is_empty_v<Proj>,
+                  "Projections with state have to be passed to the constructor");
+  }
+
+  /*!
+   * Construct a checker
+   *
+   * \param h Hash function of all shards
+   * \param p Projection
+   */
+  ConcurrentSortChecker(const Hash& h, const Proj& p)
+    : hash(h), proj(p)
+  { }
+
+  ConcurrentSortChecker(const ConcurrentSortChecker&) = delete;
+  ConcurrentSortChecker& operator = (const ConcurrentSortChecker&) = delete;
+
+  //! Process an element (before sorting)
+  void add_pre(const T& v) {
+    shard().add_pre(v);
+  }
+
+  //! Process a range of elements (before sorting)
+  template<typename Iterator>
+  void add_pre_range(Iterator begin, Iterator end) {
+    shard().add_pre_range(begin, end);
+  }
+
+  //! Process an element (after sorting) for the permutation check only
+  void add_post_unordered(const T& v) {
+    shard().add_post_unordered(v);
+  }
+
+  /*!
+   * Process the element begin[i] of an output sequence (after sorting), see
+   * SortChecker::add_post_indexed
+   */
+  template<typename Iterator, typename Comp>
+  void add_post_indexed(Iterator begin, const size_t i, Comp&& comp) {
+    shard().add_post_indexed(begin, i, comp);
+  }
+
+  //! Reset all shards. No thread may add elements at the same time.
+  void reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& s : shards) {
+      s.reset();
+    }
+  }
+
+  /*!
+   * Verify probabilistically whether the elements before sorting are
+   * a permutation of the elements after sorting. No thread may add elements
+   * at the same time.
+   */
+  bool is_likely_permuted() {
+    return merged().is_likely_permuted();
+  }
+
+  /*!
+   * Verify probabilistically whether the elements after sorting are
+   * actually the sorted output of the elements before sorting. Only
+   * neighbors compared by add_post_indexed are checked. No thread may add
+   * elements at the same time.
+   */
+  bool is_likely_sorted() {
+    return merged().is_likely_sorted();
+  }
+
+protected:
+  //! Shard of the calling thread
+  Checker& shard() {
+    return *_detail::thread_slot<Checker*>(id, [this] {
+      std::lock_guard<std::mutex> lock(mutex);
+      return static_cast<Checker*>(&shards.emplace_back(hash, proj));
+    });
+  }
+
+  //! All shards combined
+  Checker merged() {
+    std::lock_guard<std::mutex> lock(mutex);
+    Checker result(hash, proj);
+    for (const auto& s : shards) {
+      result.merge_unordered(s);
+    }
+    return result;
+  }
+
+  //! Hash function
+  const Hash hash;
+  //! Projection to the keys
+  const Proj proj;
+  //! Identifier of the checker in the threads' slot tables
+  const _detail::instance_id id;
+  //! Protects the registration of shards
+  std::mutex mutex;
+  //! Shards of the threads, a deque keeps their addresses stable
+  std::deque<_detail::cache_aligned<Checker>> shards;
+};
+
+} // namespace checker
+
+/******************************************************************************/
@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * SortChecker/include/copy.hpp
+ *
+ * Copying of the input fused with the input side of the check
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "sort_checker.hpp"
+
+namespace checker {
+namespace _detail {
+
+//! Copy n bytes with non-temporal stores, which bypass the cache
+inline void stream_copy(const void* src, void* dst, size_t n) {
+#if defined(__SSE2__)
+  const char* s = static_cast<const char*>(src);
+  char* d = static_cast<char*>(dst);
+
+  // Align the destination to 16 bytes
+  const size_t head = std::min(n, (16 - reinterpret_cast<uintptr_t>(d) % 16) % 16);
+  std::memcpy(d, s, head);
+  s += head;
+  d += head;
+  n -= head;
+
+  for (; n >= 16; n -= 16, s += 16, d += 16) {
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d),
+                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(s)));
+  }
+  std::memcpy(d, s, n);
+#else
+  std::memcpy(dst, src, n);
+#endif
+}
+
+} // namespace _detail
+
+/*!
+ * Copy n elements from src to dst and add them to the checker as input
+ * elements (before sorting).
+ *
+ * The elements are copied in blocks of about 8 KiB. Each block is hashed
+ * right after it has been copied, while it still resides in the L1 cache, so
+ * the check does not read the input from memory a second time. With
+ * non_temporal, trivially copyable elements are written with streaming
+ * stores that do not evict the input and the sort's working set from the
+ * cache.
+ *
+ * \param src Input elements
+ * \param dst Destination of the copy, must not overlap with src
+ * \param n Number of elements
+ * \param checker Checker to which the elements are added
+ * \param non_temporal Whether to use non-temporal stores
+ */
+template <typename T, typename Checker>
+void copy_and_add_pre(const T* src, T* dst, const size_t n, Checker& checker,
+                      const bool non_temporal = false) {
+  constexpr size_t block_size = sizeof(T) >= 8192 ? 1 : 8192 / sizeof(T);
+
+  for (size_t i = 0; i < n; i += block_size) {
+    const size_t m = std::min(block_size, n - i);
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      if (non_temporal) {
+        _detail::stream_copy(src + i, dst + i, m * sizeof(T));
+      } else {
+        std::memcpy(dst + i, src + i, m * sizeof(T));
+      }
+    } else {
+      std::copy(src + i, src + i + m, dst + i);
+    }
+    checker.add_pre_range(src + i, src + i + m);
+  }
+
+#if defined(__SSE2__)
+  // Order the streaming stores before subsequent accesses of dst
+  if (non_temporal) _mm_sfence();
+#endif
+}
+
+} // namespace checker
+
+/******************************************************************************/
@@ -0,0 +1,113 @@
+/*******************************************************************************
+ * SortChecker/include/execution.hpp
+ *
+ * Execution policy overloads of the checking functions
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <execution>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "parallel.hpp"
+
+namespace checker {
+namespace _detail {
+
+//! Whether the execution policy allows parallel execution
+template <typename ExecutionPolicy>
+constexpr bool is_parallel_policy_v =
+  std::is_same_v<std::decay_t<ExecutionPolicy>, std::execution::parallel_policy> ||
+  std::is_same_v<std::decay_t<ExecutionPolicy>,
+                 std::execution::parallel_unsequenced_policy>;
+
+//! Parallel loops of the standard execution policies
+template <typename ExecutionPolicy>
+struct execution_policy_traits<ExecutionPolicy, std::enable_if_t<
+    std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+  : std::true_type {
+  static constexpr bool parallel = is_parallel_policy_v<ExecutionPolicy>;
+
+  //! Number of parts of n elements, a few per hardware thread to let the
+  //! backend balance the load
+  static size_t parts(const size_t n) {
+    return std::max<size_t>(1, std::min<size_t>(
+        4 * std::max(1u, std::thread::hardware_concurrency()),
+        (n + parallel_min_elements - 1) / parallel_min_elements));
+  }
+
+  //! Call f(i, from, to) for each part [from, to) of n elements
+  template <typename Policy, typename F>
+  static void for_each_part(Policy&& policy, const size_t n, const size_t parts,
+                            F&& f) {
+    std::vector<size_t> indices(parts);
+    std::iota(indices.begin(), indices.end(), size_t { 0 });
+    std::for_each(std::forward<Policy>(policy), indices.begin(), indices.end(),
+                  [&](const size_t i) {
+      f(i, part_begin(n, parts, i), part_begin(n, parts, i + 1));
+    });
+  }
+};
+
+} // namespace _detail
+
+/*!
+ * Verify probabilistically whether the elements of [post_begin, post_end)
+ * are the sorted output of the elements of [pre_begin, pre_end), see
+ * check_sorted(PreIterator, PreIterator, PostIterator, PostIterator, Comp, size_t).
+ *
+ * With std::execution::par or par_unseq, both sequences are split into
+ * parts which are checked by the workers of the standard library's parallel
+ * backend, e.g., TBB, and the checkers of the parts are combined with
+ * 'Checker::is_likely_sorted'. With std::execution::seq or unseq, a single
+ * checker processes the sequences with the vectorized range functions.
+ *
+ * \tparam Checker Checker type, SortChecker of the value type by default
+ */
+template <typename Checker = void, typename ExecutionPolicy,
+          typename PreIterator, typename PostIterator, typename Comp,
+          typename = std::enable_if_t<
+            std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+bool check_sorted(ExecutionPolicy&& policy,
+                  PreIterator pre_begin, PreIterator pre_end,
+                  PostIterator post_begin, PostIterator post_end, Comp comp) {
+  using C = _detail::checker_for_t<Checker, PreIterator>;
+
+  if constexpr (_detail::is_parallel_policy_v<ExecutionPolicy>) {
+    using Traits = _detail::execution_policy_traits<ExecutionPolicy>;
+    const size_t n_pre = pre_end - pre_begin;
+    const size_t n_post = post_end - post_begin;
+    const size_t parts = Traits::parts(std::max(n_pre, n_post));
+
+    std::vector<C> checkers(parts);
+    std::vector<size_t> indices(parts);
+    std::iota(indices.begin(), indices.end(), size_t { 0 });
+    std::for_each(std::forward<ExecutionPolicy>(policy),
+                  indices.begin(), indices.end(), [&](const size_t i) {
+      checkers[i].add_pre_range(
+        pre_begin + _detail::part_begin(n_pre, parts, i),
+        pre_begin + _detail::part_begin(n_pre, parts, i + 1));
+      checkers[i].add_post_range(
+        post_begin + _detail::part_begin(n_post, parts, i),
+        post_begin + _detail::part_begin(n_post, parts, i + 1), comp);
+    });
+
+    return C::is_likely_sorted(checkers.begin(), checkers.end(), comp);
+  } else {
+    C checker;
+    checker.add_pre_range(pre_begin, pre_end);
+    checker.add_post_range(post_begin, post_end, comp);
+    return checker.is_likely_sorted();
+  }
+}
+
+} // namespace checker
+
+/******************************************************************************/
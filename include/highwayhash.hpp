@@ -0,0 +1,339 @@
+/*******************************************************************************
+ * SortChecker/include/highwayhash.hpp
+ *
+ * Keyed HighwayHash hash function for the checkers
+ *
+ * Translated from the portable (c/highwayhash.c) and the AVX2
+ * (highwayhash/hh_avx2.h) implementations of HighwayHash-64 in
+ * https://github.com/google/highwayhash and adapted to the hash function
+ * interface of the checkers.
+ *
+ * Copyright 2017 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "hash.hpp"
+
+namespace checker {
+namespace common {
+namespace _detail {
+
+/*!
+ * HighwayHash, see https://github.com/google/highwayhash
+ *
+ * Keyed hash function with a 256 bit key. Elements are hashed as byte
+ * sequences of 'size' bytes in packets of 32 bytes. With AVX2, the four
+ * 64 bit lanes of the state are updated in vector registers as in the AVX2
+ * implementation of HighwayHash, otherwise by the portable scalar code.
+ *
+ * The key is drawn from the seed with std::mt19937_64, so a known seed --
+ * e.g., the default seed 0 -- gives a known key. HighwayHash only withstands
+ * inputs chosen to make the check fail if the seed or the key is secret,
+ * e.g., taken from std::random_device.
+ */
+template <size_t size>
+class highway_hashing
+{
+public:
+    using hash_type = uint64_t;
+    using sum_type = sum_t<hash_type>;
+    using Key = std::array<uint64_t, 4>;
+
+    highway_hashing(size_t seed = 0) { init(seed); }
+
+    //! Use the given key
+    explicit highway_hashing(const Key& k) : key(k) { }
+
+    //! (re-)initialize the key with random values
+    void init(const size_t seed) {
+        std::mt19937_64 rng { seed };
+        for (auto& k : key) {
+            k = rng();
+        }
+    }
+
+    //! Hash an element
+    template <typename T>
+    hash_type operator () (const T& x) const {
+        static_assert(sizeof(T) == size, "Size mismatch with operand type");
+        return hash(reinterpret_cast<const uint8_t*>(&x), size);
+    }
+
+    //! Hash a byte sequence
+    hash_type hash(const uint8_t* data, const size_t length) const {
+        State state(key);
+        size_t i = 0;
+        for (; i + 32 <= length; i += 32) {
+            state.update_packet(data + i);
+        }
+        if (length - i != 0) {
+            state.update_remainder(data + i, length - i);
+        }
+        return state.finalize();
+    }
+
+    /*!
+     * Sum of the hash values of n consecutive elements. Four elements are
+     * hashed in lockstep, so the rounds of their states overlap instead of
+     * waiting for the multiplications of a single state.
+     */
+    template <typename T>
+    sum_type sum(const T* x, size_t n) const {
+        static_assert(sizeof(T) == size, "Size mismatch with operand type");
+        constexpr size_t lanes = 4;
+        constexpr size_t full = size - size % 32;
+
+        sum_type result = 0;
+        for (; n >= lanes; n -= lanes, x += lanes) {
+            const uint8_t* data = reinterpret_cast<const uint8_t*>(x);
+            State states[lanes] = { State(key), State(key), State(key), State(key) };
+            for (size_t i = 0; i < full; i += 32) {
+                for (size_t j = 0; j < lanes; ++j) {
+                    states[j].update_packet(data + j * size + i);
+                }
+            }
+            if constexpr (size % 32 != 0) {
+                for (size_t j = 0; j < lanes; ++j) {
+                    states[j].update_remainder(data + j * size + full, size % 32);
+                }
+            }
+            for (size_t r = 0; r < 4; ++r) {
+                for (size_t j = 0; j < lanes; ++j) {
+                    states[j].permute_and_update();
+                }
+            }
+            for (size_t j = 0; j < lanes; ++j) {
+                result += states[j].result();
+            }
+        }
+        for (size_t i = 0; i < n; ++i) {
+            result += (*this)(x[i]);
+        }
+        return result;
+    }
+
+protected:
+    //! The packet of the last size_mod32 bytes, 0 < size_mod32 < 32
+    static void remainder_packet(const uint8_t* bytes, const size_t size_mod32,
+                                 uint8_t packet[32]) {
+        const size_t size_mod4 = size_mod32 & 3;
+        const uint8_t* remainder = bytes + (size_mod32 & ~size_t { 3 });
+        std::memset(packet, 0, 32);
+        std::memcpy(packet, bytes, remainder - bytes);
+        if (size_mod32 & 16) {
+            for (size_t i = 0; i < 4; ++i) {
+                packet[28 + i] = remainder[static_cast<std::ptrdiff_t>(i + size_mod4) - 4];
+            }
+        } else if (size_mod4) {
+            packet[16] = remainder[0];
+            packet[16 + 1] = remainder[size_mod4 >> 1];
+            packet[16 + 2] = remainder[size_mod4 - 1];
+        }
+    }
+
+#if defined(__AVX2__)
+    //! State of four 64 bit lanes in AVX2 registers, see hh_avx2.h
+    struct State {
+        __m256i v0, v1, mul0, mul1;
+
+        explicit State(const Key& key) {
+            const __m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key.data()));
+            mul0 = _mm256_set_epi64x(0x243f6a8885a308d3ll, 0x13198a2e03707344ll,
+                                     static_cast<int64_t>(0xa4093822299f31d0ull),
+                                     static_cast<int64_t>(0xdbe6d5d5fe4cce2full));
+            mul1 = _mm256_set_epi64x(0x452821e638d01377ll,
+                                     static_cast<int64_t>(0xbe5466cf34e90c6cull),
+                                     static_cast<int64_t>(0xc0acf169b5f18a8cull),
+                                     0x3bd39e10cb0ef593ll);
+            v0 = _mm256_xor_si256(mul0, k);
+            v1 = _mm256_xor_si256(mul1, swap32(k));
+        }
+
+        //! Swap the 32 bit halves of the lanes
+        static __m256i swap32(const __m256i v) {
+            return _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+        }
+
+        //! Byte permutation of zipper_merge_and_add within each 128 bit half
+        static __m256i zipper_merge(const __m256i v) {
+            const __m256i mask = _mm256_set_epi64x(
+                0x070806090D0A040Bll, 0x000F010E05020C03ll,
+                0x070806090D0A040Bll, 0x000F010E05020C03ll);
+            return _mm256_shuffle_epi8(v, mask);
+        }
+
+        void update(const __m256i lanes) {
+            v1 = _mm256_add_epi64(v1, _mm256_add_epi64(mul0, lanes));
+            mul0 = _mm256_xor_si256(mul0, _mm256_mul_epu32(v1, _mm256_srli_epi64(v0, 32)));
+            v0 = _mm256_add_epi64(v0, mul1);
+            mul1 = _mm256_xor_si256(mul1, _mm256_mul_epu32(v0, _mm256_srli_epi64(v1, 32)));
+            v0 = _mm256_add_epi64(v0, zipper_merge(v1));
+            v1 = _mm256_add_epi64(v1, zipper_merge(v0));
+        }
+
+        void update_packet(const uint8_t* packet) {
+            update(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(packet)));
+        }
+
+        //! Process the last size_mod32 bytes, 0 < size_mod32 < 32
+        void update_remainder(const uint8_t* bytes, const size_t size_mod32) {
+            const int count = static_cast<int>(size_mod32);
+            v0 = _mm256_add_epi64(v0, _mm256_set1_epi64x(
+                (static_cast<int64_t>(count) << 32) + count));
+            const __m128i left = _mm_cvtsi32_si128(count);
+            const __m128i right = _mm_cvtsi32_si128(32 - count);
+            v1 = _mm256_or_si256(_mm256_sll_epi32(v1, left), _mm256_srl_epi32(v1, right));
+
+            uint8_t packet[32];
+            remainder_packet(bytes, size_mod32, packet);
+            update_packet(packet);
+        }
+
+        void permute_and_update() {
+            update(swap32(_mm256_permute4x64_epi64(v0, _MM_SHUFFLE(1, 0, 3, 2))));
+        }
+
+        uint64_t finalize() {
+            for (size_t i = 0; i < 4; ++i) {
+                permute_and_update();
+            }
+            return result();
+        }
+
+        //! Hash value of a finalized state
+        uint64_t result() const {
+            const __m256i sum = _mm256_add_epi64(_mm256_add_epi64(v0, v1),
+                                                 _mm256_add_epi64(mul0, mul1));
+            return static_cast<uint64_t>(_mm_cvtsi128_si64(_mm256_castsi256_si128(sum)));
+        }
+    };
+#else
+    //! State of four 64 bit lanes, see c/highwayhash.c
+    struct State {
+        uint64_t v0[4], v1[4], mul0[4], mul1[4];
+
+        explicit State(const Key& key) {
+            mul0[0] = 0xdbe6d5d5fe4cce2full;
+            mul0[1] = 0xa4093822299f31d0ull;
+            mul0[2] = 0x13198a2e03707344ull;
+            mul0[3] = 0x243f6a8885a308d3ull;
+            mul1[0] = 0x3bd39e10cb0ef593ull;
+            mul1[1] = 0xc0acf169b5f18a8cull;
+            mul1[2] = 0xbe5466cf34e90c6cull;
+            mul1[3] = 0x452821e638d01377ull;
+            for (size_t i = 0; i < 4; ++i) {
+                v0[i] = mul0[i] ^ key[i];
+                v1[i] = mul1[i] ^ ((key[i] >> 32) | (key[i] << 32));
+            }
+        }
+
+        static void zipper_merge_and_add(const uint64_t v1, const uint64_t v0,
+                                         uint64_t& add1, uint64_t& add0) {
+            add0 += (((v0 & 0xff000000ull) | (v1 & 0xff00000000ull)) >> 24) |
+                    (((v0 & 0xff0000000000ull) | (v1 & 0xff000000000000ull)) >> 16) |
+                    (v0 & 0xff0000ull) | ((v0 & 0xff00ull) << 32) |
+                    ((v1 & 0xff00000000000000ull) >> 8) | (v0 << 56);
+            add1 += (((v1 & 0xff000000ull) | (v0 & 0xff00000000ull)) >> 24) |
+                    (v1 & 0xff0000ull) | ((v1 & 0xff0000000000ull) >> 16) |
+                    ((v1 & 0xff00ull) << 24) | ((v0 & 0xff000000000000ull) >> 8) |
+                    ((v1 & 0xffull) << 48) | (v0 & 0xff00000000000000ull);
+        }
+
+        void update(const uint64_t lanes[4]) {
+            for (size_t i = 0; i < 4; ++i) {
+                v1[i] += mul0[i] + lanes[i];
+                mul0[i] ^= (v1[i] & 0xffffffffull) * (v0[i] >> 32);
+                v0[i] += mul1[i];
+                mul1[i] ^= (v0[i] & 0xffffffffull) * (v1[i] >> 32);
+            }
+            zipper_merge_and_add(v1[1], v1[0], v0[1], v0[0]);
+            zipper_merge_and_add(v1[3], v1[2], v0[3], v0[2]);
+            zipper_merge_and_add(v0[1], v0[0], v1[1], v1[0]);
+            zipper_merge_and_add(v0[3], v0[2], v1[3], v1[2]);
+        }
+
+        void update_packet(const uint8_t* packet) {
+            uint64_t lanes[4];
+            std::memcpy(lanes, packet, 32);
+            update(lanes);
+        }
+
+        static uint64_t rotate32_by(const uint64_t lane, const unsigned count) {
+            const uint32_t half0 = static_cast<uint32_t>(lane);
+            const uint32_t half1 = static_cast<uint32_t>(lane >> 32);
+            const uint32_t rot0 = (half0 << count) | (half0 >> (32 - count));
+            const uint32_t rot1 = (half1 << count) | (half1 >> (32 - count));
+            return static_cast<uint64_t>(rot0) | (static_cast<uint64_t>(rot1) << 32);
+        }
+
+        //! Process the last size_mod32 bytes, 0 < size_mod32 < 32
+        void update_remainder(const uint8_t* bytes, const size_t size_mod32) {
+            for (size_t i = 0; i < 4; ++i) {
+                v0[i] += (static_cast<uint64_t>(size_mod32) << 32) + size_mod32;
+                v1[i] = rotate32_by(v1[i], static_cast<unsigned>(size_mod32));
+            }
+
+            uint8_t packet[32];
+            remainder_packet(bytes, size_mod32, packet);
+            update_packet(packet);
+        }
+
+        void permute_and_update() {
+            const uint64_t permuted[4] = {
+                (v0[2] >> 32) | (v0[2] << 32), (v0[3] >> 32) | (v0[3] << 32),
+                (v0[0] >> 32) | (v0[0] << 32), (v0[1] >> 32) | (v0[1] << 32)
+            };
+            update(permuted);
+        }
+
+        uint64_t finalize() {
+            for (size_t i = 0; i < 4; ++i) {
+                permute_and_update();
+            }
+            return result();
+        }
+
+        //! Hash value of a finalized state
+        uint64_t result() const {
+            return v0[0] + v1[0] + mul0[0] + mul1[0];
+        }
+    };
+#endif
+
+    Key key;
+};
+
+} // namespace _detail
+
+//! HighwayHash
+template <typename T>
+using hash_highway = _detail::highway_hashing<sizeof(T)>;
+
+} // namespace common
+} // namespace checker
+
+/******************************************************************************/
@@ -0,0 +1,169 @@
+/*******************************************************************************
+ * SortChecker/include/iterators.hpp
+ *
+ * Iterator adaptors which feed the elements passing through into a checker
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+#include "sort_checker.hpp"
+
+namespace checker {
+
+/*!
+ * Output iterator which adds every element written to it to a checker as an
+ * output element (after sorting) and passes it on to the underlying output
+ * iterator. Fuses the output side of the check into the last pass of a sort
+ * which writes its output sequentially, e.g., the final merge.
+ */
+template <typename OutputIterator, typename Checker, typename Comp>
+class checking_output_iterator
+{
+public:
+  using iterator_category = std::output_iterator_tag;
+  using value_type = void;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = void;
+
+  //! Result of dereferencing which processes the assigned element
+  class proxy
+  {
+  public:
+    explicit proxy(checking_output_iterator& iterator) : it(iterator) { }
+
+    template <typename V>
+    proxy& operator = (V&& v) {
+      it.checker->add_post(v, it.comp);
+      *it.out = std::forward<V>(v);
+      return *this;
+    }
+
+  protected:
+    checking_output_iterator& it;
+  };
+
+  checking_output_iterator(OutputIterator o, Checker& c, Comp cmp)
+    : out(o), checker(&c), comp(cmp) { }
+
+  proxy operator * () { return proxy(*this); }
+
+  checking_output_iterator& operator ++ () {
+    ++out;
+    return *this;
+  }
+
+  checking_output_iterator operator ++ (int) {
+    checking_output_iterator tmp = *this;
+    ++out;
+    return tmp;
+  }
+
+  //! The underlying output iterator
+  OutputIterator base() const { return out; }
+
+protected:
+  OutputIterator out;
+  Checker* checker;
+  Comp comp;
+};
+
+//! Create a checking_output_iterator
+template <typename OutputIterator, typename Checker, typename Comp>
+checking_output_iterator<OutputIterator, Checker, Comp>
+make_checking_output_iterator(OutputIterator out, Checker& checker, Comp comp) {
+  return checking_output_iterator<OutputIterator, Checker, Comp>(out, checker, comp);
+}
+
+/*!
+ * Input iterator which adds every element it reads to a checker as an input
+ * element (before sorting). An element is processed when it is dereferenced
+ * for the first time, so each element has to be read exactly once -- as
+ * done by the first pass of a sort which copies or scatters its input.
+ */
+template <typename Iterator, typename Checker>
+class checking_input_iterator
+{
+public:
+  using iterator_category = std::input_iterator_tag;
+  using value_type = typename std::iterator_traits<Iterator>::value_type;
+  using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+  using pointer = typename std::iterator_traits<Iterator>::pointer;
+  using reference = typename std::iterator_traits<Iterator>::reference;
+
+  checking_input_iterator(Iterator i, Checker& c)
+    : it(i), checker(&c), processed(false) { }
+
+  reference operator * () const {
+    if (!processed) {
+      checker->add_pre(*it);
+      processed = true;
+    }
+    return *it;
+  }
+
+  pointer operator -> () const {
+    operator * ();
+    return std::addressof(*it);
+  }
+
+  checking_input_iterator& operator ++ () {
+    ++it;
+    processed = false;
+    return *this;
+  }
+
+  checking_input_iterator operator ++ (int) {
+    checking_input_iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  bool operator == (const checking_input_iterator& other) const {
+    return it == other.it;
+  }
+
+  bool operator != (const checking_input_iterator& other) const {
+    return it != other.it;
+  }
+
+  //! The underlying iterator
+  Iterator base() const { return it; }
+
+protected:
+  Iterator it;
+  Checker* checker;
+  //! The current element has been added to the checker
+  mutable bool processed;
+};
+
+/*!
+ * Range [begin, end) whose iterators add the elements to a checker as input
+ * elements (before sorting) while they are read, see
+ * checking_input_iterator.
+ */
+template <typename Iterator, typename Checker>
+class checking_input_view
+{
+public:
+  using iterator = checking_input_iterator<Iterator, Checker>;
+
+  checking_input_view(Iterator begin, Iterator end, Checker& checker)
+    : first(begin, checker), last(end, checker) { }
+
+  iterator begin() const { return first; }
+  iterator end() const { return last; }
+
+protected:
+  iterator first, last;
+};
+
+} // namespace checker
+
+/******************************************************************************/
@@ -0,0 +1,282 @@
+/*******************************************************************************
+ * SortChecker/include/numa.hpp
+ *
+ * Placement of checkers and hash tables on the NUMA nodes of their threads
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(CHECKER_HAS_NUMA)
+#include <numa.h>
+#include <sched.h>
+#endif
+
+#include "pool.hpp"
+#include "sort_checker.hpp"
+
+namespace checker {
+namespace _detail {
+
+/*!
+ * Whether memory is placed on specific NUMA nodes, i.e., libnuma is
+ * available and the machine has more than one node. Otherwise, all
+ * functions of this header fall back to ordinary allocations.
+ */
+inline bool numa_enabled() {
+#if defined(CHECKER_HAS_NUMA)
+  static const bool enabled = numa_available() >= 0 && numa_num_configured_nodes() > 1;
+  return enabled;
+#else
+  return false;
+#endif
+}
+
+//! NUMA node of the CPU the calling thread runs on
+inline int numa_current_node() {
+#if defined(CHECKER_HAS_NUMA)
+  if (numa_enabled()) {
+    const int cpu = sched_getcpu();
+    const int node = cpu < 0 ? -1 : numa_node_of_cpu(cpu);
+    if (node >= 0) return node;
+  }
+#endif
+  return 0;
+}
+
+//! Construct an object in memory of the given NUMA node
+template <typename T, typename... Args>
+T* numa_new(const int node, Args&&... args) {
+  void* p;
+#if defined(CHECKER_HAS_NUMA)
+  if (numa_enabled()) {
+    p = numa_alloc_onnode(sizeof(T), node);
+    if (p == nullptr) throw std::bad_alloc();
+  } else
+#endif
+  {
+    (void)node;
+    p = ::operator new(sizeof(T), std::align_val_t(alignof(T)));
+  }
+  return new (p) T(std::forward<Args>(args)...);
+}
+
+//! Destroy an object created by numa_new
+template <typename T>
+void numa_delete(T* t) {
+  if (t == nullptr) return;
+  t->~T();
+#if defined(CHECKER_HAS_NUMA)
+  if (numa_enabled()) {
+    numa_free(t, sizeof(T));
+    return;
+  }
+#endif
+  ::operator delete(t, std::align_val_t(alignof(T)));
+}
+
+//! Deleter of objects created by numa_new
+struct numa_deleter {
+  template <typename T>
+  void operator () (T* t) const { numa_delete(t); }
+};
+
+//! Detects hash functions which refer to a shared table
+template <typename Hash, typename = void>
+struct has_shared_table : std::false_type { };
+
+template <typename Hash>
+struct has_shared_table<Hash, std::void_t<typename Hash::Table,
+    decltype(Hash(std::declval<const typename Hash::Table&>()))>>
+  : std::true_type { };
+
+/*!
+ * The replica of the table of a table-based hash function and a seed on a
+ * NUMA node, see common::_detail::shared_table. Without NUMA, all nodes
+ * share one table.
+ */
+template <typename Hash>
+const typename Hash::Table& numa_shared_table(const size_t seed, const int node) {
+  using Table = typename Hash::Table;
+  if (!numa_enabled()) return common::_detail::shared_table<Hash>(seed);
+
+  static std::mutex mutex;
+  static std::map<std::pair<size_t, int>, std::unique_ptr<Table, numa_deleter>> tables;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& entry = tables[std::make_pair(seed, node)];
+  if (!entry) {
+    entry.reset(numa_new<Table>(node));
+    Hash::fill(*entry, seed);
+  }
+  return *entry;
+}
+
+} // namespace _detail
+
+/*!
+ * Hash function for the calling thread. Table-based hash functions refer to
+ * the replica of their table on the thread's NUMA node, so the lookups of
+ * threads on different sockets do not cross the interconnect. All replicas
+ * of a seed are identical, hence checkers with hash functions created on
+ * different nodes may be combined.
+ *
+ * \param seed Seed of the hash function
+ */
+template <typename Hash>
+Hash numa_local_hash(const size_t seed = 0) {
+  if constexpr (_detail::has_shared_table<Hash>::value) {
+    return Hash(_detail::numa_shared_table<Hash>(seed, _detail::numa_current_node()));
+  } else {
+    return Hash(seed);
+  }
+}
+
+/*!
+ * One checker per thread, each allocated on the NUMA node of the thread
+ * which accesses it first and using the hash tables of that node, see
+ * numa_local_hash. Without libnuma or on machines with a single node, the
+ * checkers are merely aligned to cache lines.
+ *
+ * Threads either use the checker of their index, pool[i], or obtain a
+ * checker with local(). Threads should be pinned to their CPUs, as a
+ * checker stays on its node when its thread migrates.
+ *
+ * \tparam T Type of the elements being permuted
+ * \tparam Hash Hash function
+ * \tparam Proj Projection of an element to the key it is sorted by
+ */
+template <typename T, typename Hash = common::hash_default<T>,
+          typename Proj = identity>
+class NumaCheckerPool
+{
+public:
+  using Checker = SortChecker<T, Hash, Proj>;
+
+  /*!
+   * Construct a pool with a stateless projection. The checkers are
+   * allocated on first access.
+   *
+   * \param threads Number of checkers
+   * \param seed Seed of the hash functions
+   */
+  explicit NumaCheckerPool(const size_t threads = std::thread::hardware_concurrency(),
+                           const size_t seed = 0)
+    : NumaCheckerPool(threads, seed, Proj{})
+  {
+    static_assert(std::is_empty_v<Proj>,
+                  "Projections with state have to be passed to the constructor");
+  }
+
+  /*!
+   * Construct a pool. The checkers are allocated on first access.
+   *
+   * \param threads Number of checkers
+   * \param seed Seed of the hash functions
+   * \param p Projection
+   */
+  NumaCheckerPool(const size_t threads, const size_t seed, const Proj& p)
+    : next_slot(0), hash_seed(seed), proj(p),
+      checkers(threads)
+  { }
+
+  NumaCheckerPool(const NumaCheckerPool&) = delete;
+  NumaCheckerPool& operator = (const NumaCheckerPool&) = delete;
+
+  ~NumaCheckerPool() {
+    for (auto c : checkers) {
+      _detail::numa_delete(c);
+    }
+  }
+
+  //! Number of checkers
+  size_t size() const { return checkers.size(); }
+
+  /*!
+   * Checker i, allocated on the node of the calling thread on first access.
+   * Different threads may access different checkers at the same time.
+   */
+  Checker& operator [] (const size_t i) {
+    if (checkers[i] == nullptr) {
+      checkers[i] = _detail::numa_new<padded>(_detail::numa_current_node(),
+                                              numa_local_hash<Hash>(hash_seed), proj);
+    }
+    return *checkers[i];
+  }
+
+  /*!
+   * Checker of the calling thread, assigned on the first call of the thread.
+   * At most size() threads may call this function.
+   */
+  Checker& local() {
+    const size_t slot = _detail::thread_slot<size_t>(id, [this] {
+      return next_slot.fetch_add(1, std::memory_order_relaxed);
+    });
+    assert(slot < checkers.size());
+    return (*this)[slot];
+  }
+
+  /*!
+   * Verify probabilistically whether the elements before sorting are
+   * a permutation of the elements after sorting.
+   */
+  bool is_likely_permuted() const {
+    // Without output boundaries to compare, any comparator will do
+    return merged([](const auto&, const auto&) { return false; }).is_likely_permuted();
+  }
+
+  /*!
+   * Verify probabilistically whether the elements after sorting are
+   * actually the sorted output of the elements before sorting. Checker i
+   * has to receive output elements which do not precede those of checker
+   * i - 1, see SortChecker::is_likely_sorted(Iterator, Iterator, Comp).
+   *
+   * \param comp Comparator
+   */
+  template <typename Comp>
+  bool is_likely_sorted(Comp comp) const {
+    return merged(comp).is_likely_sorted();
+  }
+
+protected:
+  using padded = _detail::cache_aligned<Checker>;
+
+  //! All checkers merged in order
+  template <typename Comp>
+  Checker merged(Comp comp) const {
+    Checker result(Hash(hash_seed), proj);
+    for (const auto c : checkers) {
+      if (c != nullptr) result.merge(*c, comp);
+    }
+    return result;
+  }
+
+  //! Identifier of the pool in the threads' slot tables
+  const _detail::instance_id id;
+  //! Next checker assigned by local()
+  std::atomic<size_t> next_slot;
+  //! Seed of the hash functions
+  const size_t hash_seed;
+  //! Projection to the keys
+  const Proj proj;
+  //! Checkers, null until first accessed
+  std::vector<padded*> checkers;
+};
+
+} // namespace checker
+
+/******************************************************************************/
@@ -0,0 +1,51 @@
+/*******************************************************************************
+ * SortChecker/include/omp.hpp
+ *
+ * OpenMP reductions of checkers
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include "sort_checker.hpp"
+
+namespace checker {
+
+//! A copy of a checker without any elements, which uses the same hash
+//! function and projection
+template <typename Checker>
+Checker empty_like(const Checker& checker) {
+  Checker empty = checker;
+  empty.reset();
+  return empty;
+}
+
+} // namespace checker
+
+#define CHECKER_PRAGMA(x) _Pragma(#x)
+
+/*!
+ * Declare the OpenMP reduction 'identifier' for the checker type 'Checker',
+ * e.g., CHECKER_DECLARE_OMP_REDUCTION(check, Checker) at namespace scope.
+ * Checker must not contain commas, use a type alias for templates with
+ * several arguments.
+ *
+ * OpenMP combines the private checkers of the threads in an unspecified
+ * order, so the reduction uses SortChecker::merge_unordered. Within the
+ * loop, add output elements with add_post_indexed, which compares each
+ * element with its predecessor in the output and works for every schedule:
+ *
+ *   Checker c;
+ *   #pragma omp parallel for reduction(check : c)
+ *   for (size_t i = 0; i < n; ++i) {
+ *     c.add_pre(in[i]);
+ *     c.add_post_indexed(out, i, comp);
+ *   }
+ */
+#define CHECKER_DECLARE_OMP_REDUCTION(identifier, Checker)                  \
+  CHECKER_PRAGMA(omp declare reduction(identifier : Checker :               \
+                 omp_out.merge_unordered(omp_in))                           \
+                 initializer(omp_priv = checker::empty_like(omp_orig)))
+
+/******************************************************************************/
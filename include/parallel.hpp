@@ -0,0 +1,184 @@
+/*******************************************************************************
+ * SortChecker/include/parallel.hpp
+ *
+ * Multithreaded checking of sorted output
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "sort_checker.hpp"
+
+namespace checker {
+namespace _detail {
+
+/*!
+ * Execute f(i) for all i in [0, threads) with one thread per i. The calling
+ * thread executes f(0).
+ */
+template <typename F>
+void parallel_for(const size_t threads, F&& f) {
+  std::vector<std::thread> workers;
+  workers.reserve(threads > 0 ? threads - 1 : 0);
+  for (size_t i = 1; i < threads; ++i) {
+    workers.emplace_back([&f, i] { f(i); });
+  }
+  if (threads > 0) f(0);
+  for (auto& w : workers) {
+    w.join();
+  }
+}
+
+//! Begin of part i of n elements split into p parts of nearly equal size
+inline size_t part_begin(const size_t n, const size_t p, const size_t i) {
+  return n / p * i + std::min(i, n % p);
+}
+
+//! SortChecker of the iterator's value type if Checker is void
+template <typename Checker, typename Iterator>
+using checker_for_t = std::conditional_t<std::is_void_v<Checker>,
+  SortChecker<typename std::iterator_traits<Iterator>::value_type>, Checker>;
+
+} // namespace _detail
+
+//! Minimum number of elements per thread of check_sorted
+constexpr size_t parallel_min_elements = size_t { 1 } << 16;
+
+/*!
+ * Verify probabilistically whether the elements of [post_begin, post_end)
+ * are the sorted output of the elements of [pre_begin, pre_end).
+ *
+ * Both sequences are split into one contiguous part per thread. Each thread
+ * processes its parts with its own checker, and the checkers are combined
+ * with 'Checker::is_likely_sorted', which also checks the boundaries between
+ * the parts of the output. Threads receive at least parallel_min_elements
+ * elements, so small inputs are checked by fewer threads.
+ *
+ * This function has one-sided error -- it may wrongly accept an incorrect
+ * output, but will never cry wolf on a correct one.
+ *
+ * \tparam Checker Checker type, SortChecker of the value type by default
+ * \param pre_begin Random access iterator to the first input element
+ * \param pre_end Random access iterator behind the last input element
+ * \param post_begin Random access iterator to the first output element
+ * \param post_end Random access iterator behind the last output element
+ * \param comp Comparator
+ * \param threads Number of threads, all hardware threads by default
+ */
+template <typename Checker = void, typename PreIterator,
+          typename PostIterator, typename Comp>
+bool check_sorted(PreIterator pre_begin, PreIterator pre_end,
+                  PostIterator post_begin, PostIterator post_end, Comp comp,
+                  size_t threads = std::thread::hardware_concurrency()) {
+  using C = _detail::checker_for_t<Checker, PreIterator>;
+
+  const size_t n_pre = pre_end - pre_begin;
+  const size_t n_post = post_end - post_begin;
+  const size_t n = std::max(n_pre, n_post);
+  threads = std::max<size_t>(1, std::min(threads,
+      (n + parallel_min_elements - 1) / parallel_min_elements));
+
+  std::vector<C> checkers(threads);
+  _detail::parallel_for(threads, [&](const size_t i) {
+    checkers[i].add_pre_range(
+      pre_begin + _detail::part_begin(n_pre, threads, i),
+      pre_begin + _detail::part_begin(n_pre, threads, i + 1));
+    checkers[i].add_post_range(
+      post_begin + _detail::part_begin(n_post, threads, i),
+      post_begin + _detail::part_begin(n_post, threads, i + 1), comp);
+  });
+
+  return C::is_likely_sorted(checkers.begin(), checkers.end(), comp);
+}
+
+/*!
+ * Minimum number of checkers per thread of the parallel aggregation
+ * functions
+ */
+constexpr size_t parallel_min_checkers = size_t { 1 } << 12;
+
+namespace _detail {
+
+/*!
+ * Merge the checkers [begin, end), which are in output order, into one
+ * checker. Each thread merges a contiguous block of checkers, then the
+ * results of the blocks are merged in order. Checkers without output
+ * elements are neutral, so blocks may start and end anywhere.
+ */
+template <typename Iterator, typename Comp>
+typename std::iterator_traits<Iterator>::value_type
+parallel_merge(Iterator begin, Iterator end, Comp comp, size_t threads) {
+  using C = typename std::iterator_traits<Iterator>::value_type;
+
+  const size_t n = end - begin;
+  threads = std::max<size_t>(1, std::min(threads,
+      (n + parallel_min_checkers - 1) / parallel_min_checkers));
+
+  std::vector<C> blocks(threads, *begin);
+  parallel_for(threads, [&](const size_t i) {
+    const size_t from = part_begin(n, threads, i);
+    const size_t to = part_begin(n, threads, i + 1);
+    C& result = blocks[i];
+    result = begin[from];
+    for (size_t j = from + 1; j < to; ++j) {
+      result.merge(begin[j], comp);
+    }
+  });
+
+  for (size_t i = 1; i < threads; ++i) {
+    blocks[0].merge(blocks[i], comp);
+  }
+  return blocks[0];
+}
+
+} // namespace _detail
+
+/*!
+ * Verify probabilistically whether the elements before sorting are a
+ * permutation of the elements after sorting, see
+ * SortChecker::is_likely_permuted(Iterator, Iterator). The checkers are
+ * aggregated by multiple threads.
+ *
+ * \param begin Random access iterator to the first checker
+ * \param end Random access iterator behind the last checker
+ * \param threads Number of threads, all hardware threads by default
+ */
+template <typename Iterator>
+bool parallel_is_likely_permuted(Iterator begin, Iterator end,
+                                 size_t threads = std::thread::hardware_concurrency()) {
+  if (begin == end) return true;
+  // Without output boundaries to compare, any comparator will do
+  return _detail::parallel_merge(begin, end, [](const auto&, const auto&) {
+    return false;
+  }, threads).is_likely_permuted();
+}
+
+/*!
+ * Verify probabilistically whether the elements after sorting are actually
+ * the sorted output of the elements before sorting, see
+ * SortChecker::is_likely_sorted(Iterator, Iterator, Comp). The checkers are
+ * aggregated by multiple threads with SortChecker::merge.
+ *
+ * \param begin Random access iterator to the first checker
+ * \param end Random access iterator behind the last checker
+ * \param comp Comparator
+ * \param threads Number of threads, all hardware threads by default
+ */
+template <typename Iterator, typename Comp>
+bool parallel_is_likely_sorted(Iterator begin, Iterator end, Comp comp,
+                               size_t threads = std::thread::hardware_concurrency()) {
+  if (begin == end) return true;
+  return _detail::parallel_merge(begin, end, comp, threads).is_likely_sorted();
+}
+
+} // namespace checker
+
+/******************************************************************************/
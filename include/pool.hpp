@@ -0,0 +1,215 @@
+/*******************************************************************************
+ * SortChecker/include/pool.hpp
+ *
+ * Per-thread checkers on separate cache lines
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "sort_checker.hpp"
+
+namespace checker {
+namespace _detail {
+
+//! Size of a cache line, the granularity of false sharing
+constexpr size_t cache_line_size = 64;
+
+/*!
+ * Identifier of an object in the threads' slot tables. The index is reused
+ * after the object is destroyed, so the tables stay as small as the number
+ * of objects alive at the same time. The generation is unique among all
+ * objects created by the process and tells a slot of the current object
+ * from a stale slot of a destroyed object with the same index.
+ */
+class instance_id
+{
+public:
+  instance_id() {
+    auto& r = get_registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    if (r.free.empty()) {
+      index = r.next_index++;
+    } else {
+      index = r.free.back();
+      r.free.pop_back();
+    }
+    generation = ++r.next_generation;
+  }
+
+  instance_id(const instance_id&) = delete;
+  instance_id& operator = (const instance_id&) = delete;
+
+  ~instance_id() {
+    auto& r = get_registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.free.push_back(index);
+  }
+
+  //! Position in the slot tables, reused after destruction
+  size_t index;
+  //! Unique identifier, never 0
+  uint64_t generation;
+
+protected:
+  struct registry {
+    std::mutex mutex;
+    //! Indices of destroyed objects
+    std::vector<size_t> free;
+    size_t next_index = 0;
+    uint64_t next_generation = 0;
+  };
+
+  static registry& get_registry() {
+    static registry r;
+    return r;
+  }
+};
+
+/*!
+ * Slot of the calling thread in the given object, e.g., an index or
+ * a pointer. The first call of a thread obtains the slot from 'make', later
+ * calls return the same slot. The slots live in a thread-local table indexed
+ * by the object's index; a slot left behind by a destroyed object is
+ * replaced when its index is reused.
+ */
+template <typename Slot, typename Make>
+Slot thread_slot(const instance_id& id, Make&& make) {
+  // Generation and slot, generation 0 marks empty entries
+  thread_local std::vector<std::pair<uint64_t, Slot>> slots;
+  if (id.index >= slots.size()) {
+    slots.resize(id.index + 1);
+  }
+  auto& entry = slots[id.index];
+  if (entry.first != id.generation) {
+    entry = std::make_pair(id.generation, make());
+  }
+  return entry.second;
+}
+
+//! Object aligned to and padded to a multiple of the cache line size
+template <typename Base>
+struct alignas(cache_line_size) cache_aligned : Base {
+  using Base::Base;
+};
+
+} // namespace _detail
+
+/*!
+ * One checker per thread, each aligned to and padded to a multiple of the
+ * cache line size so that threads updating their own checkers do not
+ * invalidate the cache lines of the other threads' checkers.
+ *
+ * Threads either use the checker of their index, pool[i], or obtain a
+ * checker with local(), which assigns the checkers to the threads in the
+ * order of their first calls.
+ *
+ * \tparam T Type of the elements being permuted
+ * \tparam Checker Checker type, SortChecker of T by default
+ */
+template <typename T, typename Checker = SortChecker<T>>
+class CheckerPool
+{
+public:
+  //! Checker on its own cache lines
+  using padded = _detail::cache_aligned<Checker>;
+
+  /*!
+   * Construct a pool
+   *
+   * \param threads Number of checkers
+   * \param args Arguments of the checkers' constructors, e.g., a hash
+   *   function referring to a shared table
+   */
+  template <typename... Args>
+  explicit CheckerPool(const size_t threads = std::thread::hardware_concurrency(),
+                       const Args&... args)
+    : next_slot(0)
+  {
+    checkers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+      checkers.emplace_back(args...);
+    }
+  }
+
+  CheckerPool(const CheckerPool&) = delete;
+  CheckerPool& operator = (const CheckerPool&) = delete;
+
+  //! Number of checkers
+  size_t size() const { return checkers.size(); }
+
+  //! Checker i
+  padded& operator [] (const size_t i) { return checkers[i]; }
+  const padded& operator [] (const size_t i) const { return checkers[i]; }
+
+  padded* begin() { return checkers.data(); }
+  padded* end() { return checkers.data() + checkers.size(); }
+  const padded* begin() const { return checkers.data(); }
+  const padded* end() const { return checkers.data() + checkers.size(); }
+
+  /*!
+   * Checker of the calling thread, assigned on the first call of the thread.
+   * At most size() threads may call this function.
+   */
+  padded& local() {
+    const size_t slot = _detail::thread_slot<size_t>(id, [this] {
+      return next_slot.fetch_add(1, std::memory_order_relaxed);
+    });
+    assert(slot < checkers.size());
+    return checkers[slot];
+  }
+
+  //! Reset all checkers
+  void reset() {
+    for (auto& c : checkers) {
+      c.reset();
+    }
+  }
+
+  /*!
+   * Verify probabilistically whether the elements before sorting are
+   * a permutation of the elements after sorting, see
+   * SortChecker::is_likely_permuted(Iterator, Iterator).
+   */
+  bool is_likely_permuted() const {
+    return Checker::is_likely_permuted(begin(), end());
+  }
+
+  /*!
+   * Verify probabilistically whether the elements after sorting are
+   * actually the sorted output of the elements before sorting, see
+   * SortChecker::is_likely_sorted(Iterator, Iterator, Comp).
+   *
+   * Checker i has to receive output elements which do not precede those of
+   * checker i - 1. Threads which obtained their checkers with local() should
+   * therefore only add input elements.
+   *
+   * \param comp Comparator
+   */
+  template <typename Comp>
+  bool is_likely_sorted(Comp comp) const {
+    return Checker::is_likely_sorted(begin(), end(), comp);
+  }
+
+protected:
+  //! Identifier of the pool in the threads' slot tables
+  const _detail::instance_id id;
+  //! Next checker assigned by local()
+  std::atomic<size_t> next_slot;
+  //! Checkers
+  std::vector<padded> checkers;
+};
+
+} // namespace checker
+
+/******************************************************************************/
@@ -0,0 +1,213 @@
+/*******************************************************************************
+ * SortChecker/include/segment.hpp
+ *
+ * Checker of an output which is written in segments in arbitrary order
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "sort_checker.hpp"
+
+namespace checker {
+
+/*!
+ * Probabilistic checker for sorted outputs which are produced in segments
+ * finished in arbitrary order by arbitrary threads, e.g., by the tasks of a
+ * work-stealing sort.
+ *
+ * Each call processes a whole segment with its own SortChecker and
+ * registers the result, keyed by the segment's offset in the output, in a
+ * lock-free list. The query sorts the non-empty segments by offset,
+ * verifies that they tile the output without gaps and overlaps, and merges
+ * them in output order, which also compares the keys at the segment
+ * boundaries. The query may only be called while no thread adds segments.
+ *
+ * \tparam T Type of the elements being permuted
+ * \tparam Hash Hash function
+ * \tparam Proj Projection of an element to the key it is sorted by
+ */
+template <typename T, typename Hash = common::hash_default<T>,
+          typename Proj = identity>
+class SegmentSortChecker
+{
+public:
+  using Checker = SortChecker<T, Hash, Proj>;
+
+  /*!
+   * Construct a checker with a stateless projection
+   *
+   * \param h Hash function of all segments
+   */
+  explicit SegmentSortChecker(const Hash& h = Hash{})
+    : SegmentSortChecker(h, Proj{})
+  {
+    static_assert(std::is_empty_v<Proj>,
+                  "Projections with state have to be passed to the constructor");
+  }
+
+  /*!
+   * Construct a checker
+   *
+   * \param h Hash function of all segments
+   * \param p Projection
+   */
+  SegmentSortChecker(const Hash& h, const Proj& p)
+    : hash(h), proj(p), head(nullptr)
+  { }
+
+  SegmentSortChecker(const SegmentSortChecker&) = delete;
+  SegmentSortChecker& operator = (const SegmentSortChecker&) = delete;
+
+  ~SegmentSortChecker() { clear(); }
+
+  /*!
+   * Process a segment of elements (before sorting). Input segments need
+   * not be keyed, as the order of the input is irrelevant.
+   *
+   * \param first Iterator to the first element
+   * \param last Iterator behind the last element
+   */
+  template<typename Iterator>
+  void add_pre_segment(Iterator first, Iterator last) {
+    segment* s = new segment(hash, proj);
+    s->checker.add_pre_range(first, last);
+    push(s);
+  }
+
+  /*!
+   * Process the segment of the output which starts at position 'offset'
+   * (after sorting).
+   *
+   * \param offset Position of the segment's first element in the output
+   * \param first Iterator to the first element
+   * \param last Iterator behind the last element
+   * \param comp Comparator
+   */
+  template<typename Iterator, typename Comp>
+  void add_post_segment(const size_t offset, Iterator first, Iterator last,
+                        Comp&& comp) {
+    segment* s = new segment(hash, proj);
+    s->is_post = true;
+    s->offset = offset;
+    s->length = std::distance(first, last);
+    s->checker.add_post_range(first, last, comp);
+    push(s);
+  }
+
+  //! Remove all segments. No thread may add segments at the same time.
+  void reset() { clear(); }
+
+  /*!
+   * Verify probabilistically whether the elements before sorting are
+   * a permutation of the elements after sorting.
+   */
+  bool is_likely_permuted() const {
+    // The order of the output segments is irrelevant, so is the comparator
+    return merged(post_segments(), [](const auto&, const auto&) {
+      return false;
+    }).is_likely_permuted();
+  }
+
+  /*!
+   * Verify probabilistically whether the output segments tile the output
+   * and are the sorted output of the elements before sorting.
+   *
+   * \param comp Comparator
+   */
+  template<typename Comp>
+  bool is_likely_sorted(Comp comp) const {
+    std::vector<const segment*> post = post_segments();
+    // Empty segments may share their offset with the following segment
+    post.erase(std::remove_if(post.begin(), post.end(), [](const segment* s) {
+      return s->length == 0;
+    }), post.end());
+    std::sort(post.begin(), post.end(), [](const segment* a, const segment* b) {
+      return a->offset < b->offset;
+    });
+
+    // The segments have to be adjacent, starting at the front of the output
+    bool tiled = true;
+    size_t end = 0;
+    for (const segment* s : post) {
+      tiled &= s->offset == end;
+      end = s->offset + s->length;
+    }
+
+    return tiled && merged(post, comp).is_likely_sorted();
+  }
+
+protected:
+  //! Result of processing a segment
+  struct segment {
+    segment(const Hash& h, const Proj& p) : checker(h, p) { }
+
+    Checker checker;
+    //! Output segment
+    bool is_post = false;
+    //! Position and length of an output segment
+    size_t offset = 0, length = 0;
+    //! Next segment in the list
+    segment* next = nullptr;
+  };
+
+  //! Insert a segment into the list
+  void push(segment* s) {
+    s->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(s->next, s, std::memory_order_release,
+                                       std::memory_order_relaxed)) { }
+  }
+
+  //! The output segments in the order of the list
+  std::vector<const segment*> post_segments() const {
+    std::vector<const segment*> post;
+    for (const segment* s = head.load(std::memory_order_acquire); s != nullptr;
+         s = s->next) {
+      if (s->is_post) post.push_back(s);
+    }
+    return post;
+  }
+
+  //! Merge the input segments and the given output segments in order
+  template<typename Comp>
+  Checker merged(const std::vector<const segment*>& post, Comp comp) const {
+    Checker result(hash, proj);
+    for (const segment* s = head.load(std::memory_order_acquire); s != nullptr;
+         s = s->next) {
+      if (!s->is_post) result.merge_unordered(s->checker);
+    }
+    for (const segment* s : post) {
+      result.merge(s->checker, comp);
+    }
+    return result;
+  }
+
+  //! Delete all segments
+  void clear() {
+    segment* s = head.exchange(nullptr, std::memory_order_acquire);
+    while (s != nullptr) {
+      segment* next = s->next;
+      delete s;
+      s = next;
+    }
+  }
+
+  //! Hash function
+  const Hash hash;
+  //! Projection to the keys
+  const Proj proj;
+  //! Lock-free list of the processed segments
+  std::atomic<segment*> head;
+};
+
+} // namespace checker
+
+/******************************************************************************/
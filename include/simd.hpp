@@ -0,0 +1,32 @@
+/*******************************************************************************
+ * SortChecker/include/simd.hpp
+ *
+ * Intrinsics of the vectorized kernels and workarounds for their headers
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+/*!
+ * Enclose code that uses AVX-512 intrinsics. Many AVX-512 intrinsics of GCC
+ * start from a deliberately undefined vector, which GCC 12 reports as
+ * uninitialized once they are inlined (GCC bug 105593), e.g., dozens of
+ * -Wmaybe-uninitialized warnings per kernel with -march=native -Wall.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#define CHECKER_AVX512_BEGIN                                      \
+  _Pragma("GCC diagnostic push")                                  \
+  _Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")     \
+  _Pragma("GCC diagnostic ignored \"-Wuninitialized\"")
+#define CHECKER_AVX512_END _Pragma("GCC diagnostic pop")
+#else
+#define CHECKER_AVX512_BEGIN
+#define CHECKER_AVX512_END
+#endif
+
+/******************************************************************************/
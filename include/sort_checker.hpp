@@ -16,12 +16,19 @@
 
 #pragma once
 #include <algorithm>
+#include <cassert>
+#include <functional>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <numeric>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "hash.hpp"
+#include "sortedness.hpp"
 
 #if defined(__GNUC__) || defined(__clang__)
 #define CHECKER_ATTRIBUTE_ALWAYS_INLINE __attribute__ ((always_inline)) inline
@@ -30,32 +37,158 @@
 #endif
 
 namespace checker {
+namespace _detail {
+
+//! Detects hash functions providing a batched 'sum(const T*, size_t)'
+template <typename Hash, typename T, typename = void>
+struct has_batched_sum : std::false_type { };
+
+template <typename Hash, typename T>
+struct has_batched_sum<Hash, T, std::void_t<decltype(
+    std::declval<const Hash&>().sum(std::declval<const T*>(), size_t { }))>>
+  : std::true_type { };
+
+//! Type used to sum up hash values: 'Hash::sum_type' if the hash function
+//! defines it and common::sum_t of its hash values otherwise
+template <typename Hash, typename = void>
+struct sum_type_of {
+  using type = common::sum_t<typename Hash::hash_type>;
+};
+
+template <typename Hash>
+struct sum_type_of<Hash, std::void_t<typename Hash::sum_type>> {
+  using type = typename Hash::sum_type;
+};
+
+//! Detects random access iterators
+template <typename Iterator>
+struct is_random_access
+  : std::is_base_of<std::random_access_iterator_tag,
+                    typename std::iterator_traits<Iterator>::iterator_category> { };
+
+//! Character types, for which std::basic_string is defined
+template <typename V>
+constexpr bool is_char_v = std::is_same_v<V, char> || std::is_same_v<V, wchar_t> ||
+  std::is_same_v<V, char16_t> || std::is_same_v<V, char32_t>;
+
+//! Detects iterators of std::basic_string
+template <typename Iterator, typename V, typename = void>
+struct is_string_iterator : std::false_type { };
+
+template <typename Iterator, typename V>
+struct is_string_iterator<Iterator, V, std::enable_if_t<is_char_v<V>>>
+  : std::bool_constant<
+      std::is_same_v<Iterator, typename std::basic_string<V>::iterator> ||
+      std::is_same_v<Iterator, typename std::basic_string<V>::const_iterator>> { };
+
+/*!
+ * Detects iterators of std::vector and std::basic_string over T, whose
+ * elements are stored contiguously, so that ranges of them can be processed
+ * as pointer ranges. Iterators of std::array are pointers in libstdc++ and
+ * libc++.
+ */
+template <typename Iterator, typename T,
+          typename V = typename std::iterator_traits<Iterator>::value_type>
+constexpr bool is_contiguous_iterator_v =
+  !std::is_pointer_v<Iterator> && std::is_same_v<V, T> && !std::is_same_v<V, bool> &&
+  (std::is_same_v<Iterator, typename std::vector<V>::iterator> ||
+   std::is_same_v<Iterator, typename std::vector<V>::const_iterator> ||
+   is_string_iterator<Iterator, V>::value);
+
+/*!
+ * Parallel loops of execution policies for the range functions of the
+ * checkers. Specialized for the standard execution policies by
+ * execution.hpp, which has to be included to pass a policy, so that this
+ * header does not depend on <execution> and its parallel backend.
+ */
+template <typename ExecutionPolicy, typename = void>
+struct execution_policy_traits : std::false_type { };
+
+} // namespace _detail
+
+//! Projection which returns its argument
+struct identity
+{
+  template <typename U>
+  constexpr U&& operator () (U&& u) const noexcept {
+    return std::forward<U>(u);
+  }
+};
 
 /*!
  * Probabilistic checker for permutation algorithms
  *
+ * The permutation check hashes whole elements, whereas the sortedness check
+ * compares the keys the elements are projected to. Only the first and the
+ * last key are stored, so a cheap projection of large records avoids
+ * copying the records.
+ *
  * \tparam T Type of the elements being permuted
+ * \tparam Hash Hash function, see common::hash_default
+ * \tparam Proj Projection of an element to the key it is sorted by
  */
-template <typename T, typename Hash = common::hash_tabulated<T>>
+template <typename T, typename Hash = common::hash_default<T>,
+          typename Proj = identity>
 class SortChecker
 {
 public:
+  //! Type of the hash value sums
+  using sum_type = typename _detail::sum_type_of<Hash>::type;
+  //! Type of the keys which are compared
+  using key_type = std::decay_t<std::invoke_result_t<const Proj&, const T&>>;
 
   /*!
    * Construct a checker
+   *
+   * Only available for stateless projections, as a default-initialized
+   * projection with state, e.g., a pointer to member, is indeterminate.
+   * Checkers with such projections are constructed from a projection or
+   * copied from a checker which was.
    */
   explicit SortChecker()
+  {
+    static_assert(std::is_empty_v<Proj>,
+                  "Projections with state have to be passed to the constructor");
+    reset();
+  }
+
+  /*!
+   * Construct a checker with a given hash function and a stateless
+   * projection
+   *
+   * All checkers whose results are aggregated must use the same hash
+   * function.
+   *
+   * \param h Hash function, e.g., referring to a shared table
+   */
+  explicit SortChecker(const Hash& h)
+    : hash(h), proj()
+  {
+    static_assert(std::is_empty_v<Proj>,
+                  "Projections with state have to be passed to the constructor");
+    reset();
+  }
+
+  /*!
+   * Construct a checker with a given hash function and projection
+   *
+   * \param h Hash function, e.g., referring to a shared table
+   * \param p Projection
+   */
+  SortChecker(const Hash& h, const Proj& p)
+    : hash(h), proj(p)
   { reset(); }
 
   //! Reset the checker's internal state
   void reset() {
     count_pre = 0;
     count_post = 0;
-    sum_pre = 0;
-    sum_post = 0;
+    sum_pre = sum_type{};
+    sum_post = sum_type{};
     post_added = false;
-    post_left = T{};
-    post_right = T{};
+    post_left = key_type{};
+    post_right = key_type{};
+    post_last = nullptr;
     sorted_locally = true;
   }
 
@@ -70,6 +203,65 @@ public:
     ++count_pre;
   }
 
+  /*!
+   * Process a range of elements (before sorting)
+   *
+   * Random access ranges are hashed with several independent accumulators,
+   * pointer ranges with the batched hash function if available. Ranges of
+   * std::vector and std::basic_string are processed as pointer ranges.
+   *
+   * \param begin Iterator to the first element
+   * \param end Iterator behind the last element
+   */
+  template<typename Iterator>
+  void add_pre_range(Iterator begin, Iterator end) {
+    if constexpr (_detail::is_contiguous_iterator_v<Iterator, T>) {
+      if (begin == end) return;
+      const T* first = std::addressof(*begin);
+      add_pre_range(first, first + (end - begin));
+    } else if constexpr (_detail::is_random_access<Iterator>::value) {
+      const size_t n = end - begin;
+      sum_pre += hash_range(begin, n);
+      count_pre += n;
+    } else {
+      for (; begin != end; ++begin) {
+        add_pre(*begin);
+      }
+    }
+  }
+
+  /*!
+   * Process a range of elements (before sorting) under an execution policy
+   *
+   * With std::execution::par or par_unseq, parts of a random access range
+   * are processed by copies of this checker on the workers of the parallel
+   * backend and merged into this checker. Otherwise, the range is processed
+   * as by add_pre_range(Iterator, Iterator). Requires execution.hpp.
+   *
+   * \param policy Execution policy, e.g., std::execution::par
+   * \param begin Iterator to the first element
+   * \param end Iterator behind the last element
+   */
+  template<typename ExecutionPolicy, typename Iterator,
+           typename = std::enable_if_t<
+             _detail::execution_policy_traits<ExecutionPolicy>::value>>
+  void add_pre_range(ExecutionPolicy&& policy, Iterator begin, Iterator end) {
+    using Traits = _detail::execution_policy_traits<ExecutionPolicy>;
+    if constexpr (Traits::parallel && _detail::is_random_access<Iterator>::value) {
+      const size_t n = end - begin;
+      std::vector<SortChecker> parts(Traits::parts(n), SortChecker(hash, proj));
+      Traits::for_each_part(std::forward<ExecutionPolicy>(policy), n, parts.size(),
+                            [&](const size_t i, const size_t from, const size_t to) {
+        parts[i].add_pre_range(begin + from, begin + to);
+      });
+      for (const auto& part : parts) {
+        merge_unordered(part);
+      }
+    } else {
+      add_pre_range(begin, end);
+    }
+  }
+
   /*!
    * Process an element (after sorting)
    *
@@ -79,16 +271,248 @@ public:
   template<typename Comp>
   CHECKER_ATTRIBUTE_ALWAYS_INLINE
   void add_post(const T& v, Comp&& comp) {
+    assert(post_last == nullptr);
     sum_post += hash(v);
     ++count_post;
 
+    decltype(auto) key = key_of(v);
     if (!post_added) {
-      post_left = v;
+      post_left = key;
+      post_added = true;
+    } else {
+      sorted_locally &= !comp(key, post_right);
+    }
+    post_right = key;
+  }
+
+  /*!
+   * Process a range of elements (after sorting)
+   *
+   * The first element is peeled off, the remaining elements are hashed and
+   * compared to their predecessors in blocks which stay in cache between
+   * both steps. Counts and boundary keys are updated once per range. Ranges
+   * of std::vector and std::basic_string are processed as pointer ranges.
+   *
+   * \param begin Forward iterator to the first element
+   * \param end Forward iterator behind the last element
+   * \param comp Comparator
+   */
+  template<typename Iterator, typename Comp>
+  void add_post_range(Iterator begin, Iterator end, Comp&& comp) {
+    assert(post_last == nullptr);
+    if (begin == end) return;
+
+    if constexpr (_detail::is_contiguous_iterator_v<Iterator, T>) {
+      const T* first = std::addressof(*begin);
+      add_post_range(first, first + (end - begin), comp);
+      return;
+    }
+
+    if (!post_added) {
+      post_left = key_of(*begin);
+      post_added = true;
+    } else {
+      sorted_locally &= !comp(key_of(*begin), post_right);
+    }
+
+    bool sorted = true;
+    if constexpr (_detail::is_random_access<Iterator>::value) {
+      const size_t n = end - begin;
+      for (size_t i = 0; i < n; i += block_size) {
+        const size_t m = std::min(block_size, n - i);
+        sum_post += hash_range(begin + i, m);
+        sorted &= sorted_pairs(begin, std::max<size_t>(i, 1), i + m, comp);
+      }
+      count_post += n;
+      post_right = key_of(*(end - 1));
+    } else {
+      sum_type sum{};
+      sum += hash(*begin);
+      uint64_t count = 1;
+      Iterator prev = begin;
+      for (Iterator it = std::next(begin); it != end; prev = it, ++it) {
+        sum += hash(*it);
+        ++count;
+        sorted &= !comp(key_of(*it), key_of(*prev));
+      }
+      sum_post += sum;
+      count_post += count;
+      post_right = key_of(*prev);
+    }
+    sorted_locally &= sorted;
+  }
+
+  /*!
+   * Process an element (after sorting) which stays in place until
+   * flush_post is called, e.g., an element of the output array.
+   *
+   * Instead of copying the key of every element, the checker keeps a
+   * pointer to the last element and compares the next element against it.
+   * The key of the last element is copied once by flush_post, which has to
+   * be called before any other function processing output elements, before
+   * merging, and before passing the checker to the static functions.
+   *
+   * \param v Element to process, must not be a temporary
+   * \param comp Comparator
+   */
+  template<typename Comp>
+  CHECKER_ATTRIBUTE_ALWAYS_INLINE
+  void add_post_tracked(const T& v, Comp&& comp) {
+    sum_post += hash(v);
+    ++count_post;
+
+    if (post_last != nullptr) {
+      sorted_locally &= !comp(key_of(v), key_of(*post_last));
+    } else if (!post_added) {
+      post_left = key_of(v);
       post_added = true;
     } else {
-      sorted_locally &= !comp(v, post_right);
+      sorted_locally &= !comp(key_of(v), post_right);
+    }
+    post_last = &v;
+  }
+
+  //! Copy the key of the last element processed with add_post_tracked
+  void flush_post() {
+    if (post_last != nullptr) {
+      post_right = key_of(*post_last);
+      post_last = nullptr;
+    }
+  }
+
+  /*!
+   * Process a range of elements (after sorting) under an execution policy
+   *
+   * With std::execution::par or par_unseq, consecutive parts of a random
+   * access range are processed by copies of this checker on the workers of
+   * the parallel backend and merged into this checker in output order.
+   * Otherwise, the range is processed as by
+   * add_post_range(Iterator, Iterator, Comp&&). Requires execution.hpp.
+   *
+   * \param policy Execution policy, e.g., std::execution::par
+   * \param begin Forward iterator to the first element
+   * \param end Forward iterator behind the last element
+   * \param comp Comparator
+   */
+  template<typename ExecutionPolicy, typename Iterator, typename Comp,
+           typename = std::enable_if_t<
+             _detail::execution_policy_traits<ExecutionPolicy>::value>>
+  void add_post_range(ExecutionPolicy&& policy, Iterator begin, Iterator end,
+                      Comp&& comp) {
+    using Traits = _detail::execution_policy_traits<ExecutionPolicy>;
+    if constexpr (Traits::parallel && _detail::is_random_access<Iterator>::value) {
+      assert(post_last == nullptr);
+      const size_t n = end - begin;
+      std::vector<SortChecker> parts(Traits::parts(n), SortChecker(hash, proj));
+      Traits::for_each_part(std::forward<ExecutionPolicy>(policy), n, parts.size(),
+                            [&](const size_t i, const size_t from, const size_t to) {
+        parts[i].add_post_range(begin + from, begin + to, comp);
+      });
+      for (const auto& part : parts) {
+        merge(part, comp);
+      }
+    } else {
+      add_post_range(begin, end, std::forward<Comp>(comp));
+    }
+  }
+
+  /*!
+   * Process the element begin[i] of an output sequence (after sorting)
+   *
+   * The element is compared to its predecessor begin[i - 1] in the output
+   * instead of the element added before. Hence, the elements of the output
+   * can be added in any order and by any number of checkers, which are
+   * combined with merge_unordered. The first and last elements of the
+   * checker are not recorded.
+   *
+   * \param begin Random access iterator to the first element of the output
+   * \param i Position of the element to process
+   * \param comp Comparator
+   */
+  template<typename Iterator, typename Comp>
+  CHECKER_ATTRIBUTE_ALWAYS_INLINE
+  void add_post_indexed(Iterator begin, const size_t i, Comp&& comp) {
+    sum_post += hash(begin[i]);
+    ++count_post;
+    if (i > 0) {
+      sorted_locally &= !comp(key_of(begin[i]), key_of(begin[i - 1]));
+    }
+  }
+
+  /*!
+   * Process an element (after sorting) for the permutation check only. The
+   * element is not compared to any other element, so the checker may be
+   * combined with merge_unordered but does not check sortedness.
+   *
+   * \param v Element to process
+   */
+  CHECKER_ATTRIBUTE_ALWAYS_INLINE
+  void add_post_unordered(const T& v) {
+    sum_post += hash(v);
+    ++count_post;
+  }
+
+  /*!
+   * Add the counts, sums, and sortedness of another checker which uses the
+   * same hash function. The result does not depend on the order in which
+   * checkers are merged.
+   *
+   * The order of the output elements of both checkers is unknown, so at most
+   * one of them may have processed elements with add_post or
+   * add_post_range -- usually, output elements are processed with
+   * add_post_indexed or add_post_unordered.
+   *
+   * \param other Checker to merge into this checker
+   */
+  void merge_unordered(const SortChecker& other) {
+    assert(!(post_added && other.post_added));
+    assert(post_last == nullptr && other.post_last == nullptr);
+
+    count_pre += other.count_pre;
+    count_post += other.count_post;
+    sum_pre += other.sum_pre;
+    sum_post += other.sum_post;
+    sorted_locally &= other.sorted_locally;
+    if (other.post_added) {
+      post_added = true;
+      post_left = other.post_left;
+      post_right = other.post_right;
+    }
+  }
+
+  /*!
+   * Append the state of another checker whose output elements follow the
+   * output elements of this checker. Adds the counts and sums and checks the
+   * boundary between the last output element of this checker and the first
+   * output element of 'right'. Checkers without output elements are
+   * neutral.
+   *
+   * The merge is associative, so checkers of consecutive parts of the
+   * output can be combined in any tree whose leaves are in output order,
+   * e.g., by a parallel reduction. The result equals
+   * is_likely_sorted(Iterator, Iterator, Comp) of the sequence of checkers.
+   *
+   * \param right Checker of the subsequent output elements
+   * \param comp Comparator
+   */
+  template<typename Comp>
+  void merge(const SortChecker& right, Comp&& comp) {
+    assert(post_last == nullptr && right.post_last == nullptr);
+
+    count_pre += right.count_pre;
+    count_post += right.count_post;
+    sum_pre += right.sum_pre;
+    sum_post += right.sum_post;
+    sorted_locally &= right.sorted_locally;
+    if (right.post_added) {
+      if (!post_added) {
+        post_added = true;
+        post_left = right.post_left;
+      } else {
+        sorted_locally &= !comp(right.post_left, post_right);
+      }
+      post_right = right.post_right;
     }
-    post_right = v;
   }
 
   /*!
@@ -133,7 +557,8 @@ public:
   template<typename Iterator>
   static bool is_likely_permuted(Iterator begin, Iterator end) {
 
-    uint64_t cpre = 0, cpost = 0, spre = 0, spost = 0;
+    uint64_t cpre = 0, cpost = 0;
+    sum_type spre{}, spost{};
 
     // Aggregate values.
     for (; begin != end; ++begin) {
@@ -174,6 +599,7 @@ public:
 
     // Elements are locally sorted.
     for (auto it = begin; it != end; ++it) {
+      assert(it->post_last == nullptr);
       succ &= it->sorted_locally;
     }
 
@@ -199,20 +625,103 @@ public:
   }
 
 protected:
+  //! Key of an element
+  CHECKER_ATTRIBUTE_ALWAYS_INLINE
+  decltype(auto) key_of(const T& v) const {
+    return std::invoke(proj, v);
+  }
+
+  //! Elements processed at once by add_post_range, about 16 KiB
+  static constexpr size_t block_size =
+    sizeof(T) >= 16384 ? 1 : 16384 / sizeof(T);
+
+  //! Sum of the hash values of n elements
+  template<typename Iterator>
+  sum_type hash_range(Iterator begin, const size_t n) const {
+    if constexpr (std::is_pointer_v<Iterator> &&
+                  _detail::has_batched_sum<Hash, T>::value) {
+      return hash.sum(begin, n);
+    } else {
+      // Independent accumulators break the dependency chain of the sum
+      sum_type s0{}, s1{}, s2{}, s3{};
+      size_t m = n;
+      for (; m >= 4; m -= 4, begin += 4) {
+        s0 += hash(begin[0]);
+        s1 += hash(begin[1]);
+        s2 += hash(begin[2]);
+        s3 += hash(begin[3]);
+      }
+      for (; m > 0; --m, ++begin) {
+        s0 += hash(*begin);
+      }
+      s0 += s1;
+      s2 += s3;
+      s0 += s2;
+      return s0;
+    }
+  }
+
+  //! Whether begin[i - 1] <= begin[i] for all i in [from, to)
+  template<typename Iterator, typename Comp>
+  bool sorted_pairs(Iterator begin, const size_t from, const size_t to,
+                    Comp&& comp) const {
+    using Simd = _detail::simd_comparator<T, std::decay_t<Comp>>;
+    if constexpr (std::is_pointer_v<Iterator> &&
+                  std::is_same_v<Proj, identity> && Simd::value) {
+      if (from >= to) return true;
+      return _detail::is_sorted_simd<T, Simd::descending>(begin + from - 1,
+                                                           to - from + 1);
+    } else {
+      bool sorted = true;
+      for (size_t i = from; i < to; ++i) {
+        sorted &= !comp(key_of(begin[i]), key_of(begin[i - 1]));
+      }
+      return sorted;
+    }
+  }
+
   //! Number of items seen in input and output
   uint64_t count_pre, count_post;
   //! Sum of hash values in input and output
-  uint64_t sum_pre, sum_post;
+  sum_type sum_pre, sum_post;
   //! Pre and post values have been added
   bool post_added;
-  //! First and last pre and post values
-  T post_left, post_right;
+  //! Keys of the first and last post values
+  key_type post_left, post_right;
+  //! Last element processed by add_post_tracked whose key is not yet copied
+  const T* post_last;
   //! Local elements are sorted
   bool sorted_locally;
   //! Hash function
   Hash hash;
+  //! Projection to the keys
+  Proj proj;
 };
 
+/*!
+ * Probabilistic checker which evaluates k independent hash functions in one
+ * pass. Accepts a wrong output only if all k hash functions fail.
+ *
+ * \tparam T Type of the elements being permuted
+ * \tparam k Number of hash functions
+ */
+template <typename T, size_t k>
+using MultiSortChecker = SortChecker<T, common::hash_tabulated_multi<T, k>>;
+
+#if defined(__SIZEOF_INT128__)
+/*!
+ * Probabilistic checker which compares the characteristic polynomials of
+ * the input and the output at k random points. The error probability is
+ * bounded independently of hash function quality, see
+ * common::_detail::polynomial_hashing.
+ *
+ * \tparam T Type of the elements being permuted
+ * \tparam k Number of evaluation points
+ */
+template <typename T, size_t k = 1>
+using PolynomialSortChecker = SortChecker<T, common::hash_polynomial<T, k>>;
+#endif
+
 } // namespace checker
 
 /******************************************************************************/
@@ -0,0 +1,182 @@
+/*******************************************************************************
+ * SortChecker/include/sortedness.hpp
+ *
+ * Vectorized checks whether arrays of arithmetic types are sorted
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+#include "simd.hpp"
+
+namespace checker {
+namespace _detail {
+
+/*!
+ * Comparators with a vectorized sortedness check for the element type T:
+ * std::less and std::greater on 32 and 64 bit integers and floating point
+ * numbers. 'descending' is true for std::greater.
+ */
+template <typename T, typename Comp, typename = void>
+struct simd_comparator : std::false_type { };
+
+template <typename T>
+constexpr bool is_simd_sortable_v =
+  (std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+   (sizeof(T) == 4 || sizeof(T) == 8)) ||
+  std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+template <typename T, typename Comp>
+struct simd_comparator<T, Comp, std::enable_if_t<is_simd_sortable_v<T> &&
+  (std::is_same_v<Comp, std::less<T>> || std::is_same_v<Comp, std::less<>>)>>
+  : std::true_type {
+  static constexpr bool descending = false;
+};
+
+template <typename T, typename Comp>
+struct simd_comparator<T, Comp, std::enable_if_t<is_simd_sortable_v<T> &&
+  (std::is_same_v<Comp, std::greater<T>> || std::is_same_v<Comp, std::greater<>>)>>
+  : std::true_type {
+  static constexpr bool descending = true;
+};
+
+#if defined(__AVX512F__)
+CHECKER_AVX512_BEGIN
+//! 'lt(a, b)' is the lane mask of a < b
+template <typename T> struct avx512_ops;
+
+template <> struct avx512_ops<int32_t> {
+  static constexpr size_t lanes = 16;
+  static __mmask16 lt(__m512i a, __m512i b) { return _mm512_cmp_epi32_mask(a, b, _MM_CMPINT_LT); }
+  static __m512i load(const int32_t* p) { return _mm512_loadu_si512(p); }
+};
+template <> struct avx512_ops<uint32_t> {
+  static constexpr size_t lanes = 16;
+  static __mmask16 lt(__m512i a, __m512i b) { return _mm512_cmp_epu32_mask(a, b, _MM_CMPINT_LT); }
+  static __m512i load(const uint32_t* p) { return _mm512_loadu_si512(p); }
+};
+template <> struct avx512_ops<int64_t> {
+  static constexpr size_t lanes = 8;
+  static __mmask8 lt(__m512i a, __m512i b) { return _mm512_cmp_epi64_mask(a, b, _MM_CMPINT_LT); }
+  static __m512i load(const int64_t* p) { return _mm512_loadu_si512(p); }
+};
+template <> struct avx512_ops<uint64_t> {
+  static constexpr size_t lanes = 8;
+  static __mmask8 lt(__m512i a, __m512i b) { return _mm512_cmp_epu64_mask(a, b, _MM_CMPINT_LT); }
+  static __m512i load(const uint64_t* p) { return _mm512_loadu_si512(p); }
+};
+template <> struct avx512_ops<float> {
+  static constexpr size_t lanes = 16;
+  static __mmask16 lt(__m512 a, __m512 b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+  static __m512 load(const float* p) { return _mm512_loadu_ps(p); }
+};
+template <> struct avx512_ops<double> {
+  static constexpr size_t lanes = 8;
+  static __mmask8 lt(__m512d a, __m512d b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+  static __m512d load(const double* p) { return _mm512_loadu_pd(p); }
+};
+CHECKER_AVX512_END
+#elif defined(__AVX2__)
+//! 'lt(a, b)' has all bits of a lane set iff a < b
+template <typename T> struct avx2_ops;
+
+template <> struct avx2_ops<int32_t> {
+  static constexpr size_t lanes = 8;
+  static __m256i lt(__m256i a, __m256i b) { return _mm256_cmpgt_epi32(b, a); }
+  static __m256i load(const int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+};
+template <> struct avx2_ops<uint32_t> {
+  static constexpr size_t lanes = 8;
+  static __m256i lt(__m256i a, __m256i b) {
+    const __m256i sign = _mm256_set1_epi32(INT32_MIN);
+    return _mm256_cmpgt_epi32(_mm256_xor_si256(b, sign), _mm256_xor_si256(a, sign));
+  }
+  static __m256i load(const uint32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+};
+template <> struct avx2_ops<int64_t> {
+  static constexpr size_t lanes = 4;
+  static __m256i lt(__m256i a, __m256i b) { return _mm256_cmpgt_epi64(b, a); }
+  static __m256i load(const int64_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+};
+template <> struct avx2_ops<uint64_t> {
+  static constexpr size_t lanes = 4;
+  static __m256i lt(__m256i a, __m256i b) {
+    const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+    return _mm256_cmpgt_epi64(_mm256_xor_si256(b, sign), _mm256_xor_si256(a, sign));
+  }
+  static __m256i load(const uint64_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+};
+template <> struct avx2_ops<float> {
+  static constexpr size_t lanes = 8;
+  static __m256i lt(__m256 a, __m256 b) { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+  static __m256 load(const float* p) { return _mm256_loadu_ps(p); }
+};
+template <> struct avx2_ops<double> {
+  static constexpr size_t lanes = 4;
+  static __m256i lt(__m256d a, __m256d b) { return _mm256_castpd_si256(_mm256_cmp_pd(a, b, _CMP_LT_OQ)); }
+  static __m256d load(const double* p) { return _mm256_loadu_pd(p); }
+};
+#endif
+
+//! The fixed-width integer type with the same representation as T
+template <typename T>
+using simd_value_t = std::conditional_t<std::is_floating_point_v<T>, T,
+  std::conditional_t<std::is_signed_v<T>,
+    std::conditional_t<sizeof(T) == 4, int32_t, int64_t>,
+    std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+
+/*!
+ * Whether x[i + 1] does not precede x[i] for all i < n - 1
+ *
+ * Compares blocks of the array with the same blocks shifted by one element
+ * and ORs the violations together, so that the loop has no branches.
+ * Without AVX2 or AVX-512, the branch-free scalar loop is left to the
+ * auto-vectorizer of the compiler.
+ *
+ * \tparam descending Whether the array is expected in descending order
+ */
+CHECKER_AVX512_BEGIN
+template <typename T, bool descending>
+bool is_sorted_simd(const T* x, const size_t n) {
+  using V = simd_value_t<T>;
+  const V* v = reinterpret_cast<const V*>(x);
+
+  size_t i = 0;
+#if defined(__AVX512F__)
+  using Ops = avx512_ops<V>;
+  uint32_t violations = 0;
+  for (; i + Ops::lanes < n; i += Ops::lanes) {
+    const auto a = Ops::load(v + i);
+    const auto b = Ops::load(v + i + 1);
+    violations |= descending ? Ops::lt(a, b) : Ops::lt(b, a);
+  }
+  bool sorted = violations == 0;
+#elif defined(__AVX2__)
+  using Ops = avx2_ops<V>;
+  __m256i violations = _mm256_setzero_si256();
+  for (; i + Ops::lanes < n; i += Ops::lanes) {
+    const auto a = Ops::load(v + i);
+    const auto b = Ops::load(v + i + 1);
+    violations = _mm256_or_si256(violations, descending ? Ops::lt(a, b) : Ops::lt(b, a));
+  }
+  bool sorted = _mm256_testz_si256(violations, violations);
+#else
+  bool sorted = true;
+#endif
+  for (; i + 1 < n; ++i) {
+    sorted &= descending ? !(v[i] < v[i + 1]) : !(v[i + 1] < v[i]);
+  }
+  return sorted;
+}
+CHECKER_AVX512_END
+
+} // namespace _detail
+} // namespace checker
+
+/******************************************************************************/
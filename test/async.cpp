@@ -0,0 +1,115 @@
+/*******************************************************************************
+ * SortChecker/test/async.cpp
+ *
+ * Tests of the bounded queue and the asynchronous checker with several
+ * producers. Configure with -DCMAKE_CXX_FLAGS=-fsanitize=thread to run them
+ * under ThreadSanitizer.
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "async.hpp"
+#include "test.hpp"
+
+//! Every item pushed by several producers is popped exactly once
+void test_queue() {
+  const size_t producers = 4, consumers = 3, items = 20000;
+  checker::_detail::bounded_queue<size_t> queue(8);
+  std::vector<std::atomic<int>> popped(producers * items);
+  std::atomic<size_t> remaining { producers * items };
+
+  std::vector<std::thread> threads;
+  for (size_t p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      for (size_t i = 0; i < items; ++i) {
+        while (!queue.try_push(p * items + i)) std::this_thread::yield();
+      }
+    });
+  }
+  for (size_t c = 0; c < consumers; ++c) {
+    threads.emplace_back([&] {
+      size_t item;
+      while (remaining.load() > 0) {
+        if (queue.try_pop(item)) {
+          popped[item].fetch_add(1);
+          remaining.fetch_sub(1);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  size_t item;
+  CHECK(!queue.try_pop(item));
+  CHECK(std::all_of(popped.begin(), popped.end(), [](const auto& p) {
+    return p.load() == 1;
+  }));
+}
+
+/*!
+ * Producers enqueue the chunks of the input and of the output, including
+ * empty chunks, into a queue of few slots
+ */
+bool check(const std::vector<uint64_t>& input, const std::vector<uint64_t>& output,
+           const size_t chunk) {
+  const size_t producers = 4;
+  checker::AsyncSortChecker<uint64_t> checker(3, 4);
+
+  std::vector<std::thread> threads;
+  for (size_t p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      for (size_t offset = p * chunk; offset < output.size(); offset += producers * chunk) {
+        const size_t n = std::min(chunk, output.size() - offset);
+        checker.add_pre_chunk(input.data() + offset, n);
+        checker.add_post_chunk(offset, output.data() + offset, 0);
+        checker.add_post_chunk(offset, output.data() + offset, n);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  return checker.finish().get();
+}
+
+int main() {
+  test_queue();
+
+  std::mt19937_64 rng { 42 };
+  const size_t n = 100000, chunk = 1000;
+  std::vector<uint64_t> input(n);
+  for (auto& e : input) e = rng();
+  std::vector<uint64_t> output = input;
+  std::sort(output.begin(), output.end());
+
+  CHECK(check(input, output, chunk));
+
+  std::vector<uint64_t> swapped = output;
+  std::swap(swapped[5 * chunk - 1], swapped[5 * chunk]);
+  CHECK(!check(input, swapped, chunk));
+
+  std::vector<uint64_t> modified = output;
+  modified[7] = modified[8];
+  CHECK(!check(input, modified, chunk));
+
+  // Destruction without finish() stops the workers
+  {
+    checker::AsyncSortChecker<uint64_t> checker(2);
+    checker.add_pre_chunk(input.data(), n);
+  }
+
+  return test::result();
+}
+
+/******************************************************************************/
@@ -0,0 +1,89 @@
+/*******************************************************************************
+ * SortChecker/test/execution.cpp
+ *
+ * Tests of the execution policy overloads of the range functions
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <list>
+#include <random>
+#include <vector>
+
+#include "execution.hpp"
+#include "test.hpp"
+
+struct Record { uint64_t key; uint64_t value; };
+
+//! Whether the checker accepts 'output' added in two ranges under the policy
+template <typename Policy, typename Checker, typename T>
+bool check(const Policy& policy, Checker checker,
+           const std::vector<T>& input, const std::vector<T>& output) {
+  const size_t half = output.size() / 2;
+  checker.add_pre_range(policy, input.begin(), input.end());
+  checker.add_post_range(policy, output.begin(), output.begin() + half, std::less<>{});
+  checker.add_post_range(policy, output.begin() + half, output.end(), std::less<>{});
+  return checker.is_likely_sorted();
+}
+
+template <typename Policy>
+void test_policy(const Policy& policy) {
+  // Several parts of parallel_min_elements per range
+  const size_t n = 5 * checker::parallel_min_elements + 123;
+  std::mt19937_64 rng { 17 };
+  std::vector<uint64_t> input(n);
+  for (auto& e : input) e = rng();
+  std::vector<uint64_t> output = input;
+  std::sort(output.begin(), output.end());
+
+  const checker::SortChecker<uint64_t> c;
+  CHECK(check(policy, c, input, output));
+
+  // Inversions within a part, at the boundary of the first two parts of the
+  // first range, and between both ranges
+  const size_t parts = checker::_detail::execution_policy_traits<Policy>::parts(n / 2);
+  const size_t boundary = checker::_detail::part_begin(n / 2, parts, 1);
+  for (const size_t i : { size_t { 7 }, boundary - 1, n / 2 - 1, n / 2, n - 2 }) {
+    std::vector<uint64_t> swapped = output;
+    std::swap(swapped[i], swapped[i + 1]);
+    CHECK(!check(policy, c, input, swapped));
+  }
+
+  std::vector<uint64_t> modified = output;
+  modified[n / 3] = modified[n / 3 + 1];
+  CHECK(!check(policy, c, input, modified));
+
+  // The parts are processed with the projection of the checker
+  std::vector<Record> records(n);
+  for (size_t i = 0; i < n; ++i) records[i] = { input[i], i };
+  std::vector<Record> sorted = records;
+  std::sort(sorted.begin(), sorted.end(),
+            [](const Record& a, const Record& b) { return a.key < b.key; });
+  using Hash = checker::common::hash_tabulated<Record>;
+  const checker::SortChecker<Record, Hash, uint64_t Record::*> r(Hash(), &Record::key);
+  CHECK(check(policy, r, records, sorted));
+  std::swap(sorted[n / 2 - 1], sorted[n / 2]);
+  CHECK(!check(policy, r, records, sorted));
+
+  // Ranges without random access are processed sequentially
+  const std::list<uint64_t> input_list(input.begin(), input.end());
+  const std::list<uint64_t> output_list(output.begin(), output.end());
+  checker::SortChecker<uint64_t> l;
+  l.add_pre_range(policy, input_list.begin(), input_list.end());
+  l.add_post_range(policy, output_list.begin(), output_list.end(), std::less<>{});
+  CHECK(l.is_likely_sorted());
+}
+
+int main() {
+  test_policy(std::execution::seq);
+  test_policy(std::execution::par);
+  test_policy(std::execution::par_unseq);
+
+  return test::result();
+}
+
+/******************************************************************************/
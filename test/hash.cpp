@@ -0,0 +1,120 @@
+/*******************************************************************************
+ * SortChecker/test/hash.cpp
+ *
+ * Tests of the hash functions
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "sort_checker.hpp"
+#include "test.hpp"
+
+//! Number of seeds for which the output 'post' of the input 'pre' is accepted
+template <typename T, typename Hash>
+size_t accepted(const std::vector<T>& pre, const std::vector<T>& post, const size_t seeds) {
+  size_t count = 0;
+  for (size_t seed = 0; seed < seeds; ++seed) {
+    checker::SortChecker<T, Hash> checker { Hash(seed) };
+    checker.add_pre_range(pre.begin(), pre.end());
+    checker.add_post_range(post.begin(), post.end(), std::less<>{});
+    count += checker.is_likely_sorted();
+  }
+  return count;
+}
+
+/*!
+ * Whether the batched sum equals the sum of the hash values of single
+ * elements, for all lengths up to 'max_n' and unaligned starts
+ */
+template <typename T, typename Hash>
+bool batched_sum_matches(const size_t max_n) {
+  std::mt19937_64 rng { 7 };
+  std::vector<T> elements(max_n + 1);
+  auto* bytes = reinterpret_cast<uint8_t*>(elements.data());
+  for (size_t i = 0; i < elements.size() * sizeof(T); ++i) {
+    bytes[i] = static_cast<uint8_t>(rng());
+  }
+
+  const Hash hash(3);
+  for (size_t start = 0; start < 2; ++start) {
+    const T* x = elements.data() + start;
+    typename Hash::sum_type expected { };
+    for (size_t n = 0; n < max_n; ++n) {
+      if (hash.sum(x, n) != expected) return false;
+      expected += hash(x[n]);
+    }
+  }
+  return true;
+}
+
+//! Keys whose size is a multiple of four bytes are gathered in vectors
+void test_tabulated() {
+  struct Key12 { uint32_t a, b, c; };
+  struct Key16 { uint64_t a, b; };
+
+  using namespace checker::common;
+  CHECK((batched_sum_matches<uint32_t, hash_tabulated<uint32_t>>(100)));
+  CHECK((batched_sum_matches<uint64_t, hash_tabulated<uint64_t>>(100)));
+  CHECK((batched_sum_matches<Key12, hash_tabulated<Key12>>(100)));
+  CHECK((batched_sum_matches<Key16, hash_tabulated<Key16>>(100)));
+}
+
+//! Keys whose difference lies in the kernel of CRC32C
+void test_crc32c() {
+  using Hash = checker::common::hash_crc32c<uint64_t>;
+  const size_t wrong = accepted<uint64_t, Hash>({ 0 }, { 0x0000000105ec76f1 }, 1000);
+  CHECK(wrong == 0);
+  const size_t right = accepted<uint64_t, Hash>({ 42 }, { 42 }, 10);
+  CHECK(right == 10);
+}
+
+void test_arithmetic() {
+  static_assert(std::is_same_v<checker::common::hash_default<uint64_t>,
+                               checker::common::hash_arithmetic<uint64_t>>);
+  static_assert(std::is_same_v<checker::common::hash_default<double>,
+                               checker::common::hash_tabulated<double>>);
+
+  using namespace checker::common;
+  CHECK((batched_sum_matches<uint8_t, hash_arithmetic<uint8_t>>(100)));
+  CHECK((batched_sum_matches<uint16_t, hash_arithmetic<uint16_t>>(100)));
+  CHECK((batched_sum_matches<uint32_t, hash_arithmetic<uint32_t>>(100)));
+  CHECK((batched_sum_matches<uint64_t, hash_arithmetic<uint64_t>>(100)));
+
+  // Outputs with the same power sums and the same sum as the input
+  using Hash = hash_arithmetic<uint64_t>;
+  const size_t pte = accepted<uint64_t, Hash>({ 0, 4, 7, 11 }, { 1, 2, 9, 10 }, 1000);
+  CHECK(pte == 0);
+  const size_t progression = accepted<uint64_t, Hash>({ 0, 3 }, { 1, 2 }, 1000);
+  CHECK(progression == 0);
+  const size_t top_bits = accepted<uint64_t, Hash>(
+    { 0, uint64_t { 3 } << 62 }, { uint64_t { 1 } << 62, uint64_t { 2 } << 62 }, 1000);
+  CHECK(top_bits == 0);
+}
+
+//! Keys of 4 and 8 bytes use the vector lanes, other keys the scalar products
+void test_polynomial() {
+  struct Key12 { uint32_t a, b, c; };
+
+  using namespace checker::common;
+  CHECK((batched_sum_matches<uint32_t, hash_polynomial<uint32_t>>(100)));
+  CHECK((batched_sum_matches<uint64_t, hash_polynomial<uint64_t>>(100)));
+  CHECK((batched_sum_matches<uint64_t, hash_polynomial<uint64_t, 2>>(100)));
+  CHECK((batched_sum_matches<Key12, hash_polynomial<Key12>>(100)));
+}
+
+int main() {
+  test_tabulated();
+  test_crc32c();
+  test_arithmetic();
+  test_polynomial();
+
+  return test::result();
+}
+
+/******************************************************************************/
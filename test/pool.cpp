@@ -0,0 +1,75 @@
+/*******************************************************************************
+ * SortChecker/test/pool.cpp
+ *
+ * Tests of the per-thread slots of pools and concurrent checkers
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "concurrent.hpp"
+#include "pool.hpp"
+#include "test.hpp"
+
+int main() {
+  // Indices are reused, generations are not
+  size_t index;
+  uint64_t generation;
+  {
+    checker::_detail::instance_id id;
+    index = id.index;
+    generation = id.generation;
+  }
+  {
+    checker::_detail::instance_id id;
+    CHECK(id.index == index);
+    CHECK(id.generation != generation);
+  }
+
+  // Pools created after others were destroyed do not see their slots
+  for (size_t i = 0; i < 1000; ++i) {
+    checker::CheckerPool<uint32_t> pool(2);
+    CHECK(&pool.local() == &pool[0]);
+    CHECK(&pool.local() == &pool[0]);
+  }
+
+  // Slots of pools alive at the same time are separate
+  {
+    checker::CheckerPool<uint32_t> a(2), b(2);
+    CHECK(&a.local() == &a[0]);
+    CHECK(&b.local() == &b[0]);
+    CHECK(&a.local() == &a[0]);
+  }
+
+  // The shard of a destroyed checker is not reused by the next checker
+  for (uint32_t i = 0; i < 1000; ++i) {
+    auto c = std::make_unique<checker::ConcurrentSortChecker<uint32_t>>();
+    c->add_pre(i);
+    c->add_post_unordered(i);
+    CHECK(c->is_likely_permuted());
+  }
+
+  // Each thread obtains its own checker
+  const size_t threads = 4;
+  for (size_t r = 0; r < 100; ++r) {
+    checker::CheckerPool<uint32_t> pool(threads);
+    std::vector<const void*> local(threads);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] { local[t] = &pool.local(); });
+    }
+    for (auto& w : workers) {
+      w.join();
+    }
+    CHECK(std::set<const void*>(local.begin(), local.end()).size() == threads);
+  }
+
+  return test::result();
+}
+
+/******************************************************************************/
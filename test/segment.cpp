@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * SortChecker/test/segment.cpp
+ *
+ * Tests of the position-keyed segment checker
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "segment.hpp"
+#include "test.hpp"
+
+using Checker = checker::SegmentSortChecker<uint32_t>;
+using Segment = std::pair<size_t, size_t>;
+
+//! Register the output segments [offset, offset + length) in random order
+bool check(const std::vector<uint32_t>& input, const std::vector<uint32_t>& output,
+           std::vector<Segment> segments, std::mt19937& rng) {
+  std::shuffle(segments.begin(), segments.end(), rng);
+  Checker checker;
+  checker.add_pre_segment(input.begin(), input.end());
+  for (const auto& [offset, length] : segments) {
+    checker.add_post_segment(offset, output.begin() + offset,
+                             output.begin() + offset + length, std::less<>{});
+  }
+  return checker.is_likely_sorted(std::less<>{});
+}
+
+int main() {
+  std::mt19937 rng { 42 };
+  const size_t n = 1000;
+  std::vector<uint32_t> input(n);
+  for (auto& e : input) e = rng();
+  std::vector<uint32_t> output = input;
+  std::sort(output.begin(), output.end());
+
+  // Empty segments at the offsets of non-empty segments and at the end
+  const std::vector<Segment> with_empty = {
+    { 0, 0 }, { 0, n / 2 }, { n / 2, 0 }, { n / 2, n / 2 }, { n, 0 }
+  };
+  for (size_t r = 0; r < 50; ++r) {
+    CHECK(check(input, output, with_empty, rng));
+  }
+
+  std::vector<Segment> tiles;
+  for (size_t i = 0; i < n; i += 37) {
+    tiles.emplace_back(i, std::min<size_t>(37, n - i));
+  }
+  CHECK(check(input, output, tiles, rng));
+
+  // Gap, overlap, and unsorted boundary between segments
+  CHECK(!check(input, output, { { 0, n / 2 }, { n / 2 + 1, n / 2 - 1 } }, rng));
+  CHECK(!check(input, output, { { 0, n / 2 + 1 }, { n / 2, n / 2 } }, rng));
+  std::vector<uint32_t> swapped = output;
+  std::swap(swapped[n / 2 - 1], swapped[n / 2]);
+  CHECK(!check(input, swapped, { { 0, n / 2 }, { n / 2, n / 2 } }, rng));
+
+  // Concurrent registration
+  Checker checker;
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      for (size_t j = t; j < tiles.size(); j += 4) {
+        const auto [offset, length] = tiles[j];
+        checker.add_pre_segment(input.begin() + offset, input.begin() + offset + length);
+        checker.add_post_segment(offset, output.begin() + offset,
+                                 output.begin() + offset + length, std::less<>{});
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  CHECK(checker.is_likely_sorted(std::less<>{}));
+
+  return test::result();
+}
+
+/******************************************************************************/
@@ -0,0 +1,149 @@
+/*******************************************************************************
+ * SortChecker/test/sortedness.cpp
+ *
+ * Tests of the vectorized sortedness check against std::is_sorted
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "sort_checker.hpp"
+#include "test.hpp"
+
+//! Random values of T over the whole range of the type, with duplicates
+template <typename T>
+std::vector<T> random_values(std::mt19937_64& rng, const size_t n) {
+  std::vector<T> values(n);
+  for (auto& v : values) {
+    if (rng() % 4 == 0 && &v != values.data()) {
+      v = *(&v - 1);
+    } else if constexpr (std::is_floating_point_v<T>) {
+      v = static_cast<T>(std::ldexp(static_cast<double>(rng() % 2001) - 1000.0,
+                                    static_cast<int>(rng() % 64) - 32));
+    } else {
+      v = static_cast<T>(rng());
+    }
+  }
+  return values;
+}
+
+/*!
+ * Whether is_sorted_simd agrees with std::is_sorted on sorted arrays of all
+ * lengths up to 'max_n', with each pair of neighbours swapped, and, for
+ * floating point types, with a NaN at each position
+ */
+template <typename T, typename Comp>
+bool agrees_with_std(const size_t max_n) {
+  using Simd = checker::_detail::simd_comparator<T, Comp>;
+  static_assert(Simd::value);
+  const Comp comp;
+  const auto simd = [](const std::vector<T>& x) {
+    return checker::_detail::is_sorted_simd<T, Simd::descending>(x.data(), x.size());
+  };
+  const auto agrees = [&](const std::vector<T>& x) {
+    return simd(x) == std::is_sorted(x.begin(), x.end(), comp);
+  };
+
+  std::mt19937_64 rng { 11 };
+  for (size_t n = 0; n <= max_n; ++n) {
+    std::vector<T> x = random_values<T>(rng, n);
+    std::sort(x.begin(), x.end(), comp);
+    if (!simd(x)) return false;
+
+    for (size_t i = 0; i + 1 < n; ++i) {
+      std::swap(x[i], x[i + 1]);
+      if (!agrees(x)) return false;
+      std::swap(x[i], x[i + 1]);
+    }
+
+    if constexpr (std::is_floating_point_v<T>) {
+      for (size_t i = 0; i < n; ++i) {
+        const T v = x[i];
+        x[i] = std::numeric_limits<T>::quiet_NaN();
+        if (!agrees(x)) return false;
+        if (i + 1 < n) {
+          std::swap(x[i], x[i + 1]);
+          if (!agrees(x)) return false;
+          std::swap(x[i], x[i + 1]);
+        }
+        x[i] = v;
+      }
+    }
+  }
+  return true;
+}
+
+//! Arrays of several vectors in every supported type and order
+template <typename T>
+bool agrees_with_std() {
+  const size_t max_n = 80;
+  return agrees_with_std<T, std::less<T>>(max_n) &&
+         agrees_with_std<T, std::less<>>(max_n) &&
+         agrees_with_std<T, std::greater<T>>(max_n) &&
+         agrees_with_std<T, std::greater<>>(max_n);
+}
+
+/*!
+ * Whether add_post_range rejects an inversion next to each boundary of its
+ * blocks and accepts the sorted output
+ */
+template <typename T, typename Comp>
+bool post_range_blocks() {
+  // add_post_range checks blocks of 16 KiB
+  const size_t block = 16384 / sizeof(T), lanes = 64 / sizeof(T);
+  const size_t n = 3 * block + 7;
+
+  std::mt19937_64 rng { 13 };
+  std::vector<T> x(n);
+  for (auto& v : x) v = static_cast<T>(rng() % 1000000);
+  std::sort(x.begin(), x.end(), Comp{});
+  x.erase(std::unique(x.begin(), x.end()), x.end());
+  const std::vector<T> input = x;
+
+  const auto accepted = [&] {
+    checker::SortChecker<T> checker;
+    checker.add_pre_range(input.begin(), input.end());
+    checker.add_post_range(x.begin(), x.end(), Comp{});
+    return checker.is_likely_sorted();
+  };
+
+  if (!accepted()) return false;
+  for (size_t b = 0; b <= x.size(); b += block) {
+    const size_t from = b > lanes ? b - lanes : 0;
+    const size_t to = std::min(b + lanes, x.size() - 1);
+    for (size_t i = from; i < to; ++i) {
+      std::swap(x[i], x[i + 1]);
+      const bool wrong = accepted();
+      std::swap(x[i], x[i + 1]);
+      if (wrong) return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+  CHECK(agrees_with_std<int32_t>());
+  CHECK(agrees_with_std<uint32_t>());
+  CHECK(agrees_with_std<int64_t>());
+  CHECK(agrees_with_std<uint64_t>());
+  CHECK(agrees_with_std<long long>());
+  CHECK(agrees_with_std<unsigned long long>());
+  CHECK(agrees_with_std<float>());
+  CHECK(agrees_with_std<double>());
+
+  CHECK((post_range_blocks<uint32_t, std::less<>>()));
+  CHECK((post_range_blocks<int64_t, std::greater<>>()));
+  CHECK((post_range_blocks<float, std::less<>>()));
+  CHECK((post_range_blocks<double, std::greater<>>()));
+
+  return test::result();
+}
+
+/******************************************************************************/
@@ -0,0 +1,38 @@
+/*******************************************************************************
+ * SortChecker/test/test.hpp
+ *
+ * Minimal assertions for the tests
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdio>
+
+namespace test {
+
+//! Number of failed checks
+inline int& failures() {
+  static int count = 0;
+  return count;
+}
+
+//! Record a failed check
+inline void fail(const char* expr, const char* file, const int line) {
+  std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+  ++failures();
+}
+
+//! Exit code of the test
+inline int result() {
+  return failures() == 0 ? 0 : 1;
+}
+
+} // namespace test
+
+//! Check a condition and report it if it does not hold
+#define CHECK(expr) \
+  do { if (!(expr)) ::test::fail(#expr, __FILE__, __LINE__); } while (false)
+
+/******************************************************************************/